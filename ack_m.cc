@@ -179,11 +179,12 @@ inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
 
 Register_Class(ackMessage)
 
-ackMessage::ackMessage(const char *name, short kind) : ::omnetpp::cMessage(name,kind)
+ackMessage::ackMessage(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
 {
+    this->seq = 0;
 }
 
-ackMessage::ackMessage(const ackMessage& other) : ::omnetpp::cMessage(other)
+ackMessage::ackMessage(const ackMessage& other) : ::omnetpp::cPacket(other)
 {
     copy(other);
 }
@@ -195,23 +196,36 @@ ackMessage::~ackMessage()
 ackMessage& ackMessage::operator=(const ackMessage& other)
 {
     if (this==&other) return *this;
-    ::omnetpp::cMessage::operator=(other);
+    ::omnetpp::cPacket::operator=(other);
     copy(other);
     return *this;
 }
 
 void ackMessage::copy(const ackMessage& other)
 {
+    this->seq = other.seq;
 }
 
 void ackMessage::parsimPack(omnetpp::cCommBuffer *b) const
 {
-    ::omnetpp::cMessage::parsimPack(b);
+    ::omnetpp::cPacket::parsimPack(b);
+    doParsimPacking(b,this->seq);
 }
 
 void ackMessage::parsimUnpack(omnetpp::cCommBuffer *b)
 {
-    ::omnetpp::cMessage::parsimUnpack(b);
+    ::omnetpp::cPacket::parsimUnpack(b);
+    doParsimUnpacking(b,this->seq);
+}
+
+unsigned int ackMessage::getSeq() const
+{
+    return this->seq;
+}
+
+void ackMessage::setSeq(unsigned int seq)
+{
+    this->seq = seq;
 }
 
 class ackMessageDescriptor : public omnetpp::cClassDescriptor
@@ -244,7 +258,7 @@ class ackMessageDescriptor : public omnetpp::cClassDescriptor
 
 Register_ClassDescriptor(ackMessageDescriptor)
 
-ackMessageDescriptor::ackMessageDescriptor() : omnetpp::cClassDescriptor("ackMessage", "omnetpp::cMessage")
+ackMessageDescriptor::ackMessageDescriptor() : omnetpp::cClassDescriptor("ackMessage", "omnetpp::cPacket")
 {
     propertynames = nullptr;
 }
@@ -279,7 +293,7 @@ const char *ackMessageDescriptor::getProperty(const char *propertyname) const
 int ackMessageDescriptor::getFieldCount() const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
-    return basedesc ? 0+basedesc->getFieldCount() : 0;
+    return basedesc ? 1+basedesc->getFieldCount() : 1;
 }
 
 unsigned int ackMessageDescriptor::getFieldTypeFlags(int field) const
@@ -290,7 +304,10 @@ unsigned int ackMessageDescriptor::getFieldTypeFlags(int field) const
             return basedesc->getFieldTypeFlags(field);
         field -= basedesc->getFieldCount();
     }
-    return 0;
+    static unsigned int fieldTypeFlags[] = {
+        FD_ISEDITABLE,
+    };
+    return (field>=0 && field<1) ? fieldTypeFlags[field] : 0;
 }
 
 const char *ackMessageDescriptor::getFieldName(int field) const
@@ -301,12 +318,17 @@ const char *ackMessageDescriptor::getFieldName(int field) const
             return basedesc->getFieldName(field);
         field -= basedesc->getFieldCount();
     }
-    return nullptr;
+    static const char *fieldNames[] = {
+        "seq",
+    };
+    return (field>=0 && field<1) ? fieldNames[field] : nullptr;
 }
 
 int ackMessageDescriptor::findField(const char *fieldName) const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    int base = basedesc ? basedesc->getFieldCount() : 0;
+    if (fieldName[0]=='s' && strcmp(fieldName, "seq")==0) return base+0;
     return basedesc ? basedesc->findField(fieldName) : -1;
 }
 
@@ -318,7 +340,10 @@ const char *ackMessageDescriptor::getFieldTypeString(int field) const
             return basedesc->getFieldTypeString(field);
         field -= basedesc->getFieldCount();
     }
-    return nullptr;
+    static const char *fieldTypeStrings[] = {
+        "unsigned int",
+    };
+    return (field>=0 && field<1) ? fieldTypeStrings[field] : nullptr;
 }
 
 const char **ackMessageDescriptor::getFieldPropertyNames(int field) const
@@ -385,6 +410,7 @@ std::string ackMessageDescriptor::getFieldValueAsString(void *object, int field,
     }
     ackMessage *pp = (ackMessage *)object; (void)pp;
     switch (field) {
+        case 0: return ulong2string(pp->getSeq());
         default: return "";
     }
 }
@@ -399,6 +425,7 @@ bool ackMessageDescriptor::setFieldValueAsString(void *object, int field, int i,
     }
     ackMessage *pp = (ackMessage *)object; (void)pp;
     switch (field) {
+        case 0: pp->setSeq(string2ulong(value)); return true;
         default: return false;
     }
 }
@@ -411,7 +438,9 @@ const char *ackMessageDescriptor::getFieldStructName(int field) const
             return basedesc->getFieldStructName(field);
         field -= basedesc->getFieldCount();
     }
-    return nullptr;
+    switch (field) {
+        default: return nullptr;
+    };
 }
 
 void *ackMessageDescriptor::getFieldStructValuePointer(void *object, int field, int i) const
@@ -21,14 +21,16 @@
 /**
  * Class generated from <tt>ack.msg:1</tt> by nedtool.
  * <pre>
- * message ackMessage
+ * packet ackMessage
  * {
+ *     unsigned int seq;
  * }
  * </pre>
  */
-class ackMessage : public ::omnetpp::cMessage
+class ackMessage : public ::omnetpp::cPacket
 {
   protected:
+    unsigned int seq;
 
   private:
     void copy(const ackMessage& other);
@@ -47,6 +49,8 @@ class ackMessage : public ::omnetpp::cMessage
     virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
 
     // field getter/setter methods
+    virtual unsigned int getSeq() const;
+    virtual void setSeq(unsigned int seq);
 };
 
 inline void doParsimPacking(omnetpp::cCommBuffer *b, const ackMessage& obj) {obj.parsimPack(b);}
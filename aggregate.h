@@ -0,0 +1,87 @@
+/*
+ * aggregate.h
+ *
+ * What a convergecast over the BFS tree collects, see BFSNode::startAggregation().
+ */
+
+#ifndef AGGREGATE_H_
+#define AGGREGATE_H_
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "aggregate_m.h"
+#include "wire_size.h"
+
+/*
+ * Count (the size of the subtree), sum, minimum and maximum of the nodes' values, the number
+ * of nodes at each depth, the deepest node (the lowest index among the deepest ones) and the largest
+ * distance of the latest sweep, for the subtree of one node. Merging is associative and commutative,
+ * so the children's aggregates can be added in whatever order they come in.
+ */
+struct Aggregate {
+    long count = 0;
+    double sum = 0;
+    double min = INFINITY;
+    double max = -INFINITY;
+    std::vector<long> depths;   // Nodes per depth, in hops from the root
+    int deepest = -1;           // Index of the deepest node, at depth depths.size() - 1
+    int sweep = -1;             // Largest hop distance from the source of the latest sweep, -1 if none
+
+    void add(double value, int depth, int node, int sweepDistance) {
+        count++;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        if((int)depths.size() <= depth)
+            depths.resize(depth + 1, 0);
+        depths[depth]++;
+        if((int)depths.size() == depth + 1 && (depths[depth] == 1 || node < deepest))
+            deepest = node;
+        sweep = std::max(sweep, sweepDistance);
+    }
+
+    /*
+     * Returns whether the deepest node is now the one of `m`.
+     */
+    bool merge(const aggregateMessage *m) {
+        bool deeper = m->getCount() > 0 && (m->getDepthsArraySize() > depths.size()
+                || (m->getDepthsArraySize() == depths.size() && m->getDeepest() < deepest));
+        if(deeper)
+            deepest = m->getDeepest();
+        sweep = std::max(sweep, m->getSweep());
+        count += m->getCount();
+        sum += m->getSum();
+        min = std::min(min, m->getMin());
+        max = std::max(max, m->getMax());
+        if(depths.size() < m->getDepthsArraySize())
+            depths.resize(m->getDepthsArraySize(), 0);
+        for(unsigned int i = 0; i < m->getDepthsArraySize(); i++)
+            depths[i] += m->getDepths(i);
+        return deeper;
+    }
+
+    void write(aggregateMessage *m) const {
+        m->setCount(count);
+        m->setSum(sum);
+        m->setMin(min);
+        m->setMax(max);
+        m->setDepthsArraySize(depths.size());
+        for(size_t i = 0; i < depths.size(); i++)
+            m->setDepths(i, depths[i]);
+        m->setDeepest(deepest);
+        m->setSweep(sweep);
+    }
+
+    /*
+     * Encoded size: the doubles in full, the counts as varints behind the length of the histogram.
+     */
+    int bits() const {
+        int bits = varintBits(count) + 3 * 64 + varintBits(depths.size()) + varintBits(deepest + 1) + varintBits(sweep + 1);
+        for(size_t i = 0; i < depths.size(); i++)
+            bits += varintBits(depths[i]);
+        return bits;
+    }
+};
+
+#endif /* AGGREGATE_H_ */
@@ -0,0 +1,637 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from aggregate.msg.
+//
+
+// Disable warnings about unused variables, empty switch stmts, etc:
+#ifdef _MSC_VER
+#  pragma warning(disable:4101)
+#  pragma warning(disable:4065)
+#endif
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wshadow"
+#  pragma clang diagnostic ignored "-Wconversion"
+#  pragma clang diagnostic ignored "-Wunused-parameter"
+#  pragma clang diagnostic ignored "-Wc++98-compat"
+#  pragma clang diagnostic ignored "-Wunreachable-code-break"
+#  pragma clang diagnostic ignored "-Wold-style-cast"
+#elif defined(__GNUC__)
+#  pragma GCC diagnostic ignored "-Wshadow"
+#  pragma GCC diagnostic ignored "-Wconversion"
+#  pragma GCC diagnostic ignored "-Wunused-parameter"
+#  pragma GCC diagnostic ignored "-Wold-style-cast"
+#  pragma GCC diagnostic ignored "-Wsuggest-attribute=noreturn"
+#  pragma GCC diagnostic ignored "-Wfloat-conversion"
+#endif
+
+#include <iostream>
+#include <sstream>
+#include "aggregate_m.h"
+
+namespace omnetpp {
+
+// Template pack/unpack rules. They are declared *after* a1l type-specific pack functions for multiple reasons.
+// They are in the omnetpp namespace, to allow them to be found by argument-dependent lookup via the cCommBuffer argument
+
+// Packing/unpacking an std::vector
+template<typename T, typename A>
+void doParsimPacking(omnetpp::cCommBuffer *buffer, const std::vector<T,A>& v)
+{
+    int n = v.size();
+    doParsimPacking(buffer, n);
+    for (int i = 0; i < n; i++)
+        doParsimPacking(buffer, v[i]);
+}
+
+template<typename T, typename A>
+void doParsimUnpacking(omnetpp::cCommBuffer *buffer, std::vector<T,A>& v)
+{
+    int n;
+    doParsimUnpacking(buffer, n);
+    v.resize(n);
+    for (int i = 0; i < n; i++)
+        doParsimUnpacking(buffer, v[i]);
+}
+
+// Packing/unpacking an std::list
+template<typename T, typename A>
+void doParsimPacking(omnetpp::cCommBuffer *buffer, const std::list<T,A>& l)
+{
+    doParsimPacking(buffer, (int)l.size());
+    for (typename std::list<T,A>::const_iterator it = l.begin(); it != l.end(); ++it)
+        doParsimPacking(buffer, (T&)*it);
+}
+
+template<typename T, typename A>
+void doParsimUnpacking(omnetpp::cCommBuffer *buffer, std::list<T,A>& l)
+{
+    int n;
+    doParsimUnpacking(buffer, n);
+    for (int i=0; i<n; i++) {
+        l.push_back(T());
+        doParsimUnpacking(buffer, l.back());
+    }
+}
+
+// Packing/unpacking an std::set
+template<typename T, typename Tr, typename A>
+void doParsimPacking(omnetpp::cCommBuffer *buffer, const std::set<T,Tr,A>& s)
+{
+    doParsimPacking(buffer, (int)s.size());
+    for (typename std::set<T,Tr,A>::const_iterator it = s.begin(); it != s.end(); ++it)
+        doParsimPacking(buffer, *it);
+}
+
+template<typename T, typename Tr, typename A>
+void doParsimUnpacking(omnetpp::cCommBuffer *buffer, std::set<T,Tr,A>& s)
+{
+    int n;
+    doParsimUnpacking(buffer, n);
+    for (int i=0; i<n; i++) {
+        T x;
+        doParsimUnpacking(buffer, x);
+        s.insert(x);
+    }
+}
+
+// Packing/unpacking an std::map
+template<typename K, typename V, typename Tr, typename A>
+void doParsimPacking(omnetpp::cCommBuffer *buffer, const std::map<K,V,Tr,A>& m)
+{
+    doParsimPacking(buffer, (int)m.size());
+    for (typename std::map<K,V,Tr,A>::const_iterator it = m.begin(); it != m.end(); ++it) {
+        doParsimPacking(buffer, it->first);
+        doParsimPacking(buffer, it->second);
+    }
+}
+
+template<typename K, typename V, typename Tr, typename A>
+void doParsimUnpacking(omnetpp::cCommBuffer *buffer, std::map<K,V,Tr,A>& m)
+{
+    int n;
+    doParsimUnpacking(buffer, n);
+    for (int i=0; i<n; i++) {
+        K k; V v;
+        doParsimUnpacking(buffer, k);
+        doParsimUnpacking(buffer, v);
+        m[k] = v;
+    }
+}
+
+// Default pack/unpack function for arrays
+template<typename T>
+void doParsimArrayPacking(omnetpp::cCommBuffer *b, const T *t, int n)
+{
+    for (int i = 0; i < n; i++)
+        doParsimPacking(b, t[i]);
+}
+
+template<typename T>
+void doParsimArrayUnpacking(omnetpp::cCommBuffer *b, T *t, int n)
+{
+    for (int i = 0; i < n; i++)
+        doParsimUnpacking(b, t[i]);
+}
+
+// Default rule to prevent compiler from choosing base class' doParsimPacking() function
+template<typename T>
+void doParsimPacking(omnetpp::cCommBuffer *, const T& t)
+{
+    throw omnetpp::cRuntimeError("Parsim error: No doParsimPacking() function for type %s", omnetpp::opp_typename(typeid(t)));
+}
+
+template<typename T>
+void doParsimUnpacking(omnetpp::cCommBuffer *, T& t)
+{
+    throw omnetpp::cRuntimeError("Parsim error: No doParsimUnpacking() function for type %s", omnetpp::opp_typename(typeid(t)));
+}
+
+}  // namespace omnetpp
+
+
+// forward
+template<typename T, typename A>
+std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec);
+
+// Template rule which fires if a struct or class doesn't have operator<<
+template<typename T>
+inline std::ostream& operator<<(std::ostream& out,const T&) {return out;}
+
+// operator<< for std::vector<T>
+template<typename T, typename A>
+inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
+{
+    out.put('{');
+    for(typename std::vector<T,A>::const_iterator it = vec.begin(); it != vec.end(); ++it)
+    {
+        if (it != vec.begin()) {
+            out.put(','); out.put(' ');
+        }
+        out << *it;
+    }
+    out.put('}');
+    
+    char buf[32];
+    sprintf(buf, " (size=%u)", (unsigned int)vec.size());
+    out.write(buf, strlen(buf));
+    return out;
+}
+
+Register_Class(aggregateMessage)
+
+aggregateMessage::aggregateMessage(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
+{
+    this->round = 0;
+    this->count = 0;
+    this->sum = 0;
+    this->min = 0;
+    this->max = 0;
+    depths_arraysize = 0;
+    this->depths = 0;
+    this->deepest = 0;
+    this->sweep = 0;
+}
+
+aggregateMessage::aggregateMessage(const aggregateMessage& other) : ::omnetpp::cPacket(other)
+{
+    depths_arraysize = 0;
+    this->depths = 0;
+    copy(other);
+}
+
+aggregateMessage::~aggregateMessage()
+{
+    delete [] this->depths;
+}
+
+aggregateMessage& aggregateMessage::operator=(const aggregateMessage& other)
+{
+    if (this==&other) return *this;
+    ::omnetpp::cPacket::operator=(other);
+    copy(other);
+    return *this;
+}
+
+void aggregateMessage::copy(const aggregateMessage& other)
+{
+    this->round = other.round;
+    this->count = other.count;
+    this->sum = other.sum;
+    this->min = other.min;
+    this->max = other.max;
+    delete [] this->depths;
+    this->depths = (other.depths_arraysize==0) ? nullptr : new long[other.depths_arraysize];
+    depths_arraysize = other.depths_arraysize;
+    for (unsigned int i=0; i<depths_arraysize; i++)
+        this->depths[i] = other.depths[i];
+    this->deepest = other.deepest;
+    this->sweep = other.sweep;
+}
+
+void aggregateMessage::parsimPack(omnetpp::cCommBuffer *b) const
+{
+    ::omnetpp::cPacket::parsimPack(b);
+    doParsimPacking(b,this->round);
+    doParsimPacking(b,this->count);
+    doParsimPacking(b,this->sum);
+    doParsimPacking(b,this->min);
+    doParsimPacking(b,this->max);
+    b->pack(depths_arraysize);
+    doParsimArrayPacking(b,this->depths,depths_arraysize);
+    doParsimPacking(b,this->deepest);
+    doParsimPacking(b,this->sweep);
+}
+
+void aggregateMessage::parsimUnpack(omnetpp::cCommBuffer *b)
+{
+    ::omnetpp::cPacket::parsimUnpack(b);
+    doParsimUnpacking(b,this->round);
+    doParsimUnpacking(b,this->count);
+    doParsimUnpacking(b,this->sum);
+    doParsimUnpacking(b,this->min);
+    doParsimUnpacking(b,this->max);
+    delete [] this->depths;
+    b->unpack(depths_arraysize);
+    if (depths_arraysize==0) {
+        this->depths = 0;
+    } else {
+        this->depths = new long[depths_arraysize];
+        doParsimArrayUnpacking(b,this->depths,depths_arraysize);
+    }
+    doParsimUnpacking(b,this->deepest);
+    doParsimUnpacking(b,this->sweep);
+}
+
+unsigned int aggregateMessage::getRound() const
+{
+    return this->round;
+}
+
+void aggregateMessage::setRound(unsigned int round)
+{
+    this->round = round;
+}
+
+long aggregateMessage::getCount() const
+{
+    return this->count;
+}
+
+void aggregateMessage::setCount(long count)
+{
+    this->count = count;
+}
+
+double aggregateMessage::getSum() const
+{
+    return this->sum;
+}
+
+void aggregateMessage::setSum(double sum)
+{
+    this->sum = sum;
+}
+
+double aggregateMessage::getMin() const
+{
+    return this->min;
+}
+
+void aggregateMessage::setMin(double min)
+{
+    this->min = min;
+}
+
+double aggregateMessage::getMax() const
+{
+    return this->max;
+}
+
+void aggregateMessage::setMax(double max)
+{
+    this->max = max;
+}
+
+void aggregateMessage::setDepthsArraySize(unsigned int size)
+{
+    long *depths2 = (size==0) ? nullptr : new long[size];
+    unsigned int sz = depths_arraysize < size ? depths_arraysize : size;
+    for (unsigned int i=0; i<sz; i++)
+        depths2[i] = this->depths[i];
+    for (unsigned int i=sz; i<size; i++)
+        depths2[i] = 0;
+    depths_arraysize = size;
+    delete [] this->depths;
+    this->depths = depths2;
+}
+
+unsigned int aggregateMessage::getDepthsArraySize() const
+{
+    return depths_arraysize;
+}
+
+long aggregateMessage::getDepths(unsigned int k) const
+{
+    if (k>=depths_arraysize) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", depths_arraysize, k);
+    return this->depths[k];
+}
+
+void aggregateMessage::setDepths(unsigned int k, long depths)
+{
+    if (k>=depths_arraysize) throw omnetpp::cRuntimeError("Array of size %d indexed by %d", depths_arraysize, k);
+    this->depths[k] = depths;
+}
+
+int aggregateMessage::getDeepest() const
+{
+    return this->deepest;
+}
+
+void aggregateMessage::setDeepest(int deepest)
+{
+    this->deepest = deepest;
+}
+
+int aggregateMessage::getSweep() const
+{
+    return this->sweep;
+}
+
+void aggregateMessage::setSweep(int sweep)
+{
+    this->sweep = sweep;
+}
+
+class aggregateMessageDescriptor : public omnetpp::cClassDescriptor
+{
+  private:
+    mutable const char **propertynames;
+  public:
+    aggregateMessageDescriptor();
+    virtual ~aggregateMessageDescriptor();
+
+    virtual bool doesSupport(omnetpp::cObject *obj) const override;
+    virtual const char **getPropertyNames() const override;
+    virtual const char *getProperty(const char *propertyname) const override;
+    virtual int getFieldCount() const override;
+    virtual const char *getFieldName(int field) const override;
+    virtual int findField(const char *fieldName) const override;
+    virtual unsigned int getFieldTypeFlags(int field) const override;
+    virtual const char *getFieldTypeString(int field) const override;
+    virtual const char **getFieldPropertyNames(int field) const override;
+    virtual const char *getFieldProperty(int field, const char *propertyname) const override;
+    virtual int getFieldArraySize(void *object, int field) const override;
+
+    virtual const char *getFieldDynamicTypeString(void *object, int field, int i) const override;
+    virtual std::string getFieldValueAsString(void *object, int field, int i) const override;
+    virtual bool setFieldValueAsString(void *object, int field, int i, const char *value) const override;
+
+    virtual const char *getFieldStructName(int field) const override;
+    virtual void *getFieldStructValuePointer(void *object, int field, int i) const override;
+};
+
+Register_ClassDescriptor(aggregateMessageDescriptor)
+
+aggregateMessageDescriptor::aggregateMessageDescriptor() : omnetpp::cClassDescriptor("aggregateMessage", "omnetpp::cPacket")
+{
+    propertynames = nullptr;
+}
+
+aggregateMessageDescriptor::~aggregateMessageDescriptor()
+{
+    delete[] propertynames;
+}
+
+bool aggregateMessageDescriptor::doesSupport(omnetpp::cObject *obj) const
+{
+    return dynamic_cast<aggregateMessage *>(obj)!=nullptr;
+}
+
+const char **aggregateMessageDescriptor::getPropertyNames() const
+{
+    if (!propertynames) {
+        static const char *names[] = {  nullptr };
+        omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+        const char **basenames = basedesc ? basedesc->getPropertyNames() : nullptr;
+        propertynames = mergeLists(basenames, names);
+    }
+    return propertynames;
+}
+
+const char *aggregateMessageDescriptor::getProperty(const char *propertyname) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    return basedesc ? basedesc->getProperty(propertyname) : nullptr;
+}
+
+int aggregateMessageDescriptor::getFieldCount() const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    return basedesc ? 8+basedesc->getFieldCount() : 8;
+}
+
+unsigned int aggregateMessageDescriptor::getFieldTypeFlags(int field) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldTypeFlags(field);
+        field -= basedesc->getFieldCount();
+    }
+    static unsigned int fieldTypeFlags[] = {
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISARRAY | FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
+    };
+    return (field>=0 && field<8) ? fieldTypeFlags[field] : 0;
+}
+
+const char *aggregateMessageDescriptor::getFieldName(int field) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldName(field);
+        field -= basedesc->getFieldCount();
+    }
+    static const char *fieldNames[] = {
+        "round",
+        "count",
+        "sum",
+        "min",
+        "max",
+        "depths",
+        "deepest",
+        "sweep",
+    };
+    return (field>=0 && field<8) ? fieldNames[field] : nullptr;
+}
+
+int aggregateMessageDescriptor::findField(const char *fieldName) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    int base = basedesc ? basedesc->getFieldCount() : 0;
+    if (fieldName[0]=='r' && strcmp(fieldName, "round")==0) return base+0;
+    if (fieldName[0]=='c' && strcmp(fieldName, "count")==0) return base+1;
+    if (fieldName[0]=='s' && strcmp(fieldName, "sum")==0) return base+2;
+    if (fieldName[0]=='m' && strcmp(fieldName, "min")==0) return base+3;
+    if (fieldName[0]=='m' && strcmp(fieldName, "max")==0) return base+4;
+    if (fieldName[0]=='d' && strcmp(fieldName, "depths")==0) return base+5;
+    if (fieldName[0]=='d' && strcmp(fieldName, "deepest")==0) return base+6;
+    if (fieldName[0]=='s' && strcmp(fieldName, "sweep")==0) return base+7;
+    return basedesc ? basedesc->findField(fieldName) : -1;
+}
+
+const char *aggregateMessageDescriptor::getFieldTypeString(int field) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldTypeString(field);
+        field -= basedesc->getFieldCount();
+    }
+    static const char *fieldTypeStrings[] = {
+        "unsigned int",
+        "long",
+        "double",
+        "double",
+        "double",
+        "long",
+        "int",
+        "int",
+    };
+    return (field>=0 && field<8) ? fieldTypeStrings[field] : nullptr;
+}
+
+const char **aggregateMessageDescriptor::getFieldPropertyNames(int field) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldPropertyNames(field);
+        field -= basedesc->getFieldCount();
+    }
+    switch (field) {
+        default: return nullptr;
+    }
+}
+
+const char *aggregateMessageDescriptor::getFieldProperty(int field, const char *propertyname) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldProperty(field, propertyname);
+        field -= basedesc->getFieldCount();
+    }
+    switch (field) {
+        default: return nullptr;
+    }
+}
+
+int aggregateMessageDescriptor::getFieldArraySize(void *object, int field) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldArraySize(object, field);
+        field -= basedesc->getFieldCount();
+    }
+    aggregateMessage *pp = (aggregateMessage *)object; (void)pp;
+    switch (field) {
+        case 5: return pp->getDepthsArraySize();
+        default: return 0;
+    }
+}
+
+const char *aggregateMessageDescriptor::getFieldDynamicTypeString(void *object, int field, int i) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldDynamicTypeString(object,field,i);
+        field -= basedesc->getFieldCount();
+    }
+    aggregateMessage *pp = (aggregateMessage *)object; (void)pp;
+    switch (field) {
+        default: return nullptr;
+    }
+}
+
+std::string aggregateMessageDescriptor::getFieldValueAsString(void *object, int field, int i) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldValueAsString(object,field,i);
+        field -= basedesc->getFieldCount();
+    }
+    aggregateMessage *pp = (aggregateMessage *)object; (void)pp;
+    switch (field) {
+        case 0: return ulong2string(pp->getRound());
+        case 1: return long2string(pp->getCount());
+        case 2: return double2string(pp->getSum());
+        case 3: return double2string(pp->getMin());
+        case 4: return double2string(pp->getMax());
+        case 5: return long2string(pp->getDepths(i));
+        case 6: return long2string(pp->getDeepest());
+        case 7: return long2string(pp->getSweep());
+        default: return "";
+    }
+}
+
+bool aggregateMessageDescriptor::setFieldValueAsString(void *object, int field, int i, const char *value) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->setFieldValueAsString(object,field,i,value);
+        field -= basedesc->getFieldCount();
+    }
+    aggregateMessage *pp = (aggregateMessage *)object; (void)pp;
+    switch (field) {
+        case 0: pp->setRound(string2ulong(value)); return true;
+        case 1: pp->setCount(string2long(value)); return true;
+        case 2: pp->setSum(string2double(value)); return true;
+        case 3: pp->setMin(string2double(value)); return true;
+        case 4: pp->setMax(string2double(value)); return true;
+        case 5: pp->setDepths(i,string2long(value)); return true;
+        case 6: pp->setDeepest(string2long(value)); return true;
+        case 7: pp->setSweep(string2long(value)); return true;
+        default: return false;
+    }
+}
+
+const char *aggregateMessageDescriptor::getFieldStructName(int field) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldStructName(field);
+        field -= basedesc->getFieldCount();
+    }
+    switch (field) {
+        default: return nullptr;
+    };
+}
+
+void *aggregateMessageDescriptor::getFieldStructValuePointer(void *object, int field, int i) const
+{
+    omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    if (basedesc) {
+        if (field < basedesc->getFieldCount())
+            return basedesc->getFieldStructValuePointer(object, field, i);
+        field -= basedesc->getFieldCount();
+    }
+    aggregateMessage *pp = (aggregateMessage *)object; (void)pp;
+    switch (field) {
+        default: return nullptr;
+    }
+}
+
+
@@ -0,0 +1,92 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from aggregate.msg.
+//
+
+#ifndef __AGGREGATE_M_H
+#define __AGGREGATE_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>aggregate.msg:1</tt> by nedtool.
+ * <pre>
+ * packet aggregateMessage
+ * {
+ *     unsigned int round;
+ *     long count;
+ *     double sum;
+ *     double min;
+ *     double max;
+ *     long depths[];
+ *     int deepest;
+ *     int sweep;
+ * }
+ * </pre>
+ */
+class aggregateMessage : public ::omnetpp::cPacket
+{
+  protected:
+    unsigned int round;
+    long count;
+    double sum;
+    double min;
+    double max;
+    long *depths; // array ptr
+    unsigned int depths_arraysize;
+    int deepest;
+    int sweep;
+
+  private:
+    void copy(const aggregateMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const aggregateMessage&);
+
+  public:
+    aggregateMessage(const char *name=nullptr, short kind=0);
+    aggregateMessage(const aggregateMessage& other);
+    virtual ~aggregateMessage();
+    aggregateMessage& operator=(const aggregateMessage& other);
+    virtual aggregateMessage *dup() const override {return new aggregateMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual unsigned int getRound() const;
+    virtual void setRound(unsigned int round);
+    virtual long getCount() const;
+    virtual void setCount(long count);
+    virtual double getSum() const;
+    virtual void setSum(double sum);
+    virtual double getMin() const;
+    virtual void setMin(double min);
+    virtual double getMax() const;
+    virtual void setMax(double max);
+    virtual void setDepthsArraySize(unsigned int size);
+    virtual unsigned int getDepthsArraySize() const;
+    virtual long getDepths(unsigned int k) const;
+    virtual void setDepths(unsigned int k, long depths);
+    virtual int getDeepest() const;
+    virtual void setDeepest(int deepest);
+    virtual int getSweep() const;
+    virtual void setSweep(int sweep);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const aggregateMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, aggregateMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __AGGREGATE_M_H
+
@@ -0,0 +1,65 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from aggregate_query.msg.
+//
+
+#ifndef __AGGREGATE_QUERY_M_H
+#define __AGGREGATE_QUERY_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>aggregate_query.msg:1</tt> by nedtool.
+ * <pre>
+ * packet aggregateQueryMessage
+ * {
+ *     unsigned int round;
+ *     int depth;
+ * }
+ * </pre>
+ */
+class aggregateQueryMessage : public ::omnetpp::cPacket
+{
+  protected:
+    unsigned int round;
+    int depth;
+
+  private:
+    void copy(const aggregateQueryMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const aggregateQueryMessage&);
+
+  public:
+    aggregateQueryMessage(const char *name=nullptr, short kind=0);
+    aggregateQueryMessage(const aggregateQueryMessage& other);
+    virtual ~aggregateQueryMessage();
+    aggregateQueryMessage& operator=(const aggregateQueryMessage& other);
+    virtual aggregateQueryMessage *dup() const override {return new aggregateQueryMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual unsigned int getRound() const;
+    virtual void setRound(unsigned int round);
+    virtual int getDepth() const;
+    virtual void setDepth(int depth);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const aggregateQueryMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, aggregateQueryMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __AGGREGATE_QUERY_M_H
+
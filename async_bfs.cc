@@ -5,171 +5,542 @@
  *      Author: burak
  */
 
-#include <omnetpp.h>
 #include <algorithm>
+#include <limits.h>
 #include <string.h>
 #include <stdio.h>
-#include <list>
-#include "ack_m.h"
-#include "layer_m.h"
-#include "reject_m.h"
-
-#define DELAYED true            // Choose whether messages should be delivered with a delay or not
-
-using namespace omnetpp;
-
-class Node : public cSimpleModule {
-    simtime_t last_creation_time_processed = 0;
-    std::list<int> children;    // List to keep our children nodes
-    std::list<int> other;       // List to keep our other nodes
-    int my_layer = INT_MAX;     // When a node is created its layer is set to INT_MAX
-    int parent = -1;            // Parent is set to -1 initially which will let us distinguish which nodes have parents and not.
-
-    void initialize() override;
-    void handleMessage(cMessage *msg) override;
-    void finish() override;
-
-    layerMessage* createLayerMessage(int layer, simtime_t s = simTime());   // Creates a layerMessage with given parameters
-    ackMessage* createAckMessage();                                         // Creates an ackMessage
-    rejectMessage* createRejectMessage();                                   // Creates a rejectMessage
-
-    void handleLayerMessage(layerMessage *lMsg);                            // Handles layerMessage(s) received
-    void handleAckMessage(ackMessage *aMsg);                                // Handles ackMessage(s) received
-    void handleRejectMessage(rejectMessage *rMsg);                          // Handles rejectMessage(s) received
-
-    void printParentNode();                                                 // Prints out the node's parent node
-    void printChildrenNodes();                                              // Prints out the node's children nodes
-    void printOtherNodes();                                                 // Prints out the node's other nodes
-    void printLayer();                                                      // Prints out the node's layer
-
-    bool setParent(layerMessage *lMsg);
-    void setParentPathColor();
-    void undoParentPathColor();
-    void hideOtherNodes();
-public:
-    int getParent() { return parent; }
-};
+#include "async_bfs.h"
+#include "topology_builder.h"
+#include "traffic_generator.h"
 
 Define_Module(Node);
+Define_Module(ImmediateNode);
+Define_Module(FastNode);
+Define_Module(CompactNode);
+Define_Module(ProfiledNode);
+Define_Module(LatencyNode);
+Define_Module(CostNode);
 
-void Node::handleMessage(cMessage *msg) {
-    if(msg->isSelfMessage()) { // If the message is a self message
-        bubble("Initiating...");
-        layerMessage *lMsg = createLayerMessage(my_layer + 1);
-        for(int i = 0; i < gateCount() / 2; i++) {
-            if(DELAYED)
-                sendDelayed(lMsg->dup(), intuniform(1, 1000), "port$o", i);
-            else
-            send(lMsg->dup(), "port$o", i);
+/*
+ * Compares two layers and returns true if l1 < l2, false otherwise.
+ */
+template<typename D>
+bool compareLayers(D l1, D l2) {
+    return l1 < l2;
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleMessage(cMessage *msg) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_HANDLE_MESSAGE);
+    if(P::statistics && getSimulation()->getFES()->getLength() > peakFesLength)
+        peakFesLength = getSimulation()->getFES()->getLength();
+
+    if(P::options && transport.isTimer(msg)) {
+        if(!crashed)                                                // Nothing of ours is on its way any more, see crash()
+            transport.handleTimer(msg);
+    } else if(msg == aggregateTimer) {
+        startAggregation();
+    } else if(msg->isSelfMessage()) { // If the message is a self message
+        if(P::gui)
+            showBubble("Initiating...");
+        if(!crashed && root)                                        // Not if it was rerooted away in the meantime
+            broadcastLayer(-1);
+        delete msg;
+    } else {
+        int port = msg->getArrivalGate()->getIndex();
+        if(repairing() && (crashed || !portUp[port] || msg->getCreationTime() < portUpSince[port])) {
+            failureDrops++;                                             // Lost with the node or the link
+            if(P::statistics)
+                MemoryAccount::get().addMessage(msg, -1);
+            delete msg;
+            msg = nullptr;
+        } else if(P::options) {
+            msg = transport.receive(msg, port);                         // Lost messages, duplicates and link acks stop here
         }
-        delete lMsg;
+        if(msg)
+            deliver(msg, port);
+    }
+    if(P::options)
+        transport.endOfEvent();
+    if(P::statistics)
+        updateMemoryAccount();
+}
+
+/*
+ * Hands a message that has arrived through `port` to dispatch(), unpacking bundles.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::deliver(cMessage *msg, int port) {
+    if(P::options && msg->getKind() == 4) {                             // If the message is a bundleMessage, handle its messages one by one
+        bundleMessage *bMsg = check_and_cast<bundleMessage *>(msg);
+        for(int i = 0; i < bMsg->getMessageCount(); i++) {
+            cMessage *m = bMsg->removeMessage(i);
+            take(m);
+            dispatch(m, port);
+        }
+        if(P::statistics)
+            MemoryAccount::get().remove(MEM_BUNDLE, 1, sizeof(bundleMessage) + bMsg->getMessageCount() * sizeof(cMessage *));
+        delete bMsg;
     } else {
-        switch(msg->getKind()) {
-        case 0: {                                                       // If the message is a cMessage
-        } break;
-        case 1: {                                                       // If the message is a layerMessage
-            layerMessage *lMsg = check_and_cast<layerMessage *>(msg);   // Cast the received msg pointer to its appropriate type
-            handleLayerMessage(lMsg);                                   // Call appropriate handler function for the message
-        } break;
-        case 2: {                                                       // If the message is ackMessage
-            ackMessage *aMsg = check_and_cast<ackMessage *>(msg);       // Cast the received msg pointer to its appropriate type
-            handleAckMessage(aMsg);                                     // Call appropriate handler function for the message
-        } break;
-        case 3: {                                                       // If the message is rejectMessage
-            rejectMessage *rMsg = check_and_cast<rejectMessage *>(msg); // Cast the received msg pointer to its appropriate type
-            handleRejectMessage(rMsg);                                  // Call appropriate handler function for the message
-        } break;
+        dispatch(msg, port);
+    }
+}
+
+/*
+ * Passes a protocol message that has arrived through `port` to its handler.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::dispatch(cMessage *msg, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_DISPATCH);
+    switch(msg->getKind()) {
+    case 0: {                                                       // If the message is a cMessage
+    } break;
+    case 1: {                                                       // If the message is a layerMessage
+        Message *lMsg = check_and_cast<Message *>(msg);             // Cast the received msg pointer to its appropriate type
+        if(((P::options && dropStale) || repairing()) && isStale(lMsg, port)) {  // A newer layer from the same neighbour has already been handled
+            staleLayersDropped++;
+            if(P::statistics)
+                MemoryAccount::get().remove(MEM_LAYER, 1, sizeof(Message));
+            delete lMsg;
+            break;
+        }
+        if(repairing() && lMsg->getEpoch() != epoch) {
+            if(lMsg->getEpoch() < epoch) {                          // From the tree before the last reroot
+                staleLayersDropped++;
+                if(P::statistics)
+                    MemoryAccount::get().remove(MEM_LAYER, 1, sizeof(Message));
+                delete lMsg;
+                break;
+            }
+            enterEpoch(lMsg->getEpoch());
+        }
+        if(repairing() && clearing) {                               // Possibly derived from our old route; rejoin() asks again
+            if(P::statistics)
+                MemoryAccount::get().remove(MEM_LAYER, 1, sizeof(Message));
+            delete lMsg;
+            break;
         }
+        if(repairing() && !compareLayers(Distance<D>::get(lMsg), distanceBound)) {  // Counting to infinity after the root has been cut off
+            staleLayersDropped++;
+            if(P::statistics)
+                MemoryAccount::get().remove(MEM_LAYER, 1, sizeof(Message));
+            delete lMsg;
+            break;
+        }
+        if(repairing() && relabelPending)
+            relabel(lMsg, port);
+        else
+            handleLayerMessage(lMsg, port);                         // Call appropriate handler function for the message
+    } break;
+    case 2: {                                                       // If the message is ackMessage
+        ackMessage *aMsg = check_and_cast<ackMessage *>(msg);       // Cast the received msg pointer to its appropriate type
+        handleAckMessage(aMsg, port);                               // Call appropriate handler function for the message
+    } break;
+    case 3: {                                                       // If the message is rejectMessage
+        rejectMessage *rMsg = check_and_cast<rejectMessage *>(msg); // Cast the received msg pointer to its appropriate type
+        handleRejectMessage(rMsg, port);                            // Call appropriate handler function for the message
+    } break;
+    case 8: case 9: case 10: case 11: {                             // If the message is one of the repairMessages
+        repairMessage *rMsg = check_and_cast<repairMessage *>(msg);
+        handleRepairMessage(rMsg, port);
+    } break;
+    case 12: {                                                      // If the message is an aggregateQueryMessage
+        aggregateQueryMessage *qMsg = check_and_cast<aggregateQueryMessage *>(msg);
+        handleAggregateQuery(qMsg, port);
+    } break;
+    case 13: {                                                      // If the message is an aggregateMessage
+        aggregateMessage *aMsg = check_and_cast<aggregateMessage *>(msg);
+        handleAggregateMessage(aMsg, port);
+    } break;
+    case 14: {                                                      // If the message is a labelMessage
+        labelMessage *lMsg = check_and_cast<labelMessage *>(msg);
+        handleLabelMessage(lMsg, port);
+    } break;
+    case 15: {                                                      // If the message is a data packet
+        dataMessage *dMsg = check_and_cast<dataMessage *>(msg);
+        route(dMsg);
+    } break;
+    case 16: {                                                      // If the message is a sweepMessage
+        sweepMessage *sMsg = check_and_cast<sweepMessage *>(msg);
+        handleSweepMessage(sMsg, port);
+    } break;
     }
 }
 
-void Node::initialize() {
+/*
+ * Everything happens in stage 1, because the TopologyBuilder may still be adding ports in stage 0.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::initialize(int stage) {
+    if(stage != 1)
+        return;
+
+    // Resolve the neighbour behind each port once, so that nobody has to walk the gate path again later on
+    neighbours.resize(gateSize("port"));
+    for(int i = 0; i < gateSize("port"); i++)
+        neighbours[i] = gate("port$o", i)->getPathEndGate()->getOwnerModule()->getIndex();
+    announced.assign(gateSize("port"), false);
+    if(P::options) {                    // Without the options policy these stay off, whatever NED says
+        piggyback = par("piggyback").boolValue();
+        dropStale = par("dropStale").boolValue();
+        dag = par("dag").boolValue();
+        layerPriority = par("layerPriority").boolValue();
+        adversarialDelay = strcmp(par("delayMode").stringValue(), "adversarial") == 0;
+        if(!adversarialDelay && strcmp(par("delayMode").stringValue(), "uniform") != 0)
+            throw cRuntimeError("Unknown delay mode `%s'", par("delayMode").stringValue());
+        transport.init(this, gateSize("port"), LinkTransport::parseMode(par("bundling").stringValue()));
+        if(par("reliable").boolValue())
+            transport.initReliability(par("retransmitTimeout"), par("maxRetransmissions").intValue(), par("timerWheelResolution"));
+        floodAggregation = strcmp(par("aggregation").stringValue(), "flood") == 0;
+        if(!floodAggregation && strcmp(par("aggregation").stringValue(), "tree") != 0)
+            throw cRuntimeError("Unknown aggregation mode `%s'", par("aggregation").stringValue());
+        aggregateValue = par("aggregateValue").doubleValue();
+        routing = par("routing").boolValue();
+        diameter = par("diameter").boolValue();
+        if(routing)
+            traffic = dynamic_cast<TrafficGenerator *>(getParentModule()->getSubmodule("traffic"));
+        if(par("maxLayer").doubleValue() >= 0)
+            maxLayer = Distance<D>::fromDouble(par("maxLayer").doubleValue());
+    } else if(repair) {
+        throw cRuntimeError("%s has the repair compiled out, failures need a node type with the protocol options", getNedTypeName());
+    }
+    nodeCount = getVectorSize();
+    if(dagMode())
+        dagParents.assign(gateSize("port"), false);
+    lastTimeFrame.assign(gateSize("port"), -1);
+    lastLayer.assign(gateSize("port"), Distance<D>::infinity());
+    weights.init(this);
+    if(repairing()) {
+        portUp.assign(gateSize("port"), true);
+        portUpSince.assign(gateSize("port"), SIMTIME_ZERO);
+        lastSeq.assign(gateSize("port"), 0);
+        // No shortest path has more than nodeCount - 1 links, nor a link heavier than the heaviest of the network
+        TopologyBuilder *builder = check_and_cast<TopologyBuilder *>(getParentModule()->getSubmodule("builder"));
+        distanceBound = Distance<D>::fromDouble(nodeCount * builder->getHeaviestLink(W<D>::parameter()));
+    }
+    if(P::statistics) {
+        layerVector.setName("layer");
+        transport.accountMemory = true;
+        MemoryAccount::get().setMessageBytes(1, sizeof(Message));
+        MemoryAccount::get().setMessageBytes(2, sizeof(ackMessage));
+        MemoryAccount::get().setMessageBytes(3, sizeof(rejectMessage));
+        for(short kind = 8; kind <= 11; kind++)
+            MemoryAccount::get().setMessageBytes(kind, sizeof(repairMessage));
+        MemoryAccount::get().setMessageBytes(12, sizeof(aggregateQueryMessage));
+        MemoryAccount::get().setMessageBytes(13, sizeof(aggregateMessage));
+        MemoryAccount::get().setMessageBytes(14, sizeof(labelMessage));
+        MemoryAccount::get().setMessageBytes(16, sizeof(sweepMessage));
+        int64_t state = sizeof(*this)
+                + neighbours.capacity() * sizeof(int) + announced.capacity() / 8 + dagParents.capacity() / 8
+                + lastTimeFrame.capacity() * sizeof(simtime_t) + lastLayer.capacity() * sizeof(D)
+                + 2 * gateSize("port") * sizeof(cGate);
+        MemoryAccount::get().add(MEM_NODE_STATE, 1, state);
+    }
+    if(P::gui && getEnvir()->isGUI()) {
+        maxBubbles = par("maxBubbles").intValue();
+        bubbleWindow = par("bubbleWindow").doubleValue();
+        linkGates.resize(2 * gateSize("port"));
+        for(int i = 0; i < gateSize("port"); i++) {
+            linkGates[2 * i] = gate("port$o", i);
+            cGate *end = linkGates[2 * i]->getPathEndGate();
+            linkGates[2 * i + 1] = end->getOwnerModule()->gate("port$o", end->getIndex());
+        }
+    }
+
     // Root scheduling a self-message to initiate the process
-    if(getIndex() == 0) {
-        my_layer = 0;
+    root = getIndex() == 0;
+    if(root) {
+        my_layer = Distance<D>::zero();
+        lastChange = simTime();
         getDisplayString().parse("i=,red");
         cMessage *msg = new cMessage;
         scheduleAt(10.0, msg);
+        if(P::options && par("aggregateAt").doubleValue() >= 0) {
+            aggregateRoundsLeft = par("aggregateRounds").intValue();
+            aggregateInterval = par("aggregateInterval");
+            aggregateTimer = new cMessage("aggregate");
+            scheduleAt(par("aggregateAt"), aggregateTimer);
+        }
     }
 }
 
 /*
  * Creates a layerMessage with the given arguments and returns a pointer to it.
  * simtime_t s parameter is optional, if not given simTime() is used instead.
+ * With `layerPriority` the layer becomes the scheduling priority, so that among the messages due at the
+ * same time the smaller layers are handled first and fewer nodes take a parent they will drop again.
+ * Other messages keep priority 0 and go before the layers. Weighted distances are rounded down, but
+ * their arrival times rarely tie anyway.
  */
-layerMessage* Node::createLayerMessage(int layer, simtime_t s) {
-    layerMessage *lMessage = new layerMessage;
-    lMessage->setLayer(layer);
+template<typename D, template<typename> class W, typename P>
+typename BFSNode<D, W, P>::Message* BFSNode<D, W, P>::createLayerMessage(D layer, simtime_t s) {
+    Message *lMessage = new Message;
+    Distance<D>::set(lMessage, layer);
     lMessage->setTimeFrame(s);
+    lMessage->setSeq(++layerSeq);
+    lMessage->setEpoch(epoch);
     lMessage->setKind(1);
+    if(P::options && layerPriority)
+        lMessage->setSchedulingPriority((short)std::min(Distance<D>::toDouble(layer), (double)(SHRT_MAX - 1)));
+    lMessage->setBitLength(KIND_BITS + Distance<D>::bits(layer));  // The timeFrame stamp is simulation bookkeeping, not sent
+    if(repairing())
+        lMessage->addBitLength(varintBits(layerSeq) + varintBits(epoch));  // Sequence number and epoch only go on the wire for the repair
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_LAYER, 1, sizeof(Message));
     return lMessage;
 }
 
 /*
  * Creates an Ack message setting its `kind` to 2
  * so that we can distinguish the message from cMessage and others.
+ * `seq` is that of the layerMessage we are acknowledging, only sent for the repair.
  * Returns a pointer to created ackMessage.
  */
-ackMessage* Node::createAckMessage() {
+template<typename D, template<typename> class W, typename P>
+ackMessage* BFSNode<D, W, P>::createAckMessage(unsigned int seq) {
     ackMessage *ackMsg = new ackMessage;
     ackMsg->setKind(2);
+    ackMsg->setSeq(seq);
+    ackMsg->setBitLength(KIND_BITS + (repairing() ? varintBits(seq) : 0));
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_ACK, 1, sizeof(ackMessage));
     return ackMsg;
 }
 
 /*
  * Creates a Reject message setting its `kind` to 3
  * so that we can distinguis the message from cMessage and others.
+ * A non-zero `seq` turns down an ack for that layerMessage, only sent for the repair.
  * Returns a pointer to created rejectMessage.
  */
-rejectMessage* Node::createRejectMessage() {
+template<typename D, template<typename> class W, typename P>
+rejectMessage* BFSNode<D, W, P>::createRejectMessage(unsigned int seq) {
     rejectMessage *rMessage = new rejectMessage;
     rMessage->setKind(3);
+    rMessage->setSeq(seq);
+    rMessage->setBitLength(KIND_BITS + (repairing() ? varintBits(seq) : 0));
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_REJECT, 1, sizeof(rejectMessage));
     return rMessage;
 }
 
 /*
- * Compares two layers and returns true if l1 < l2, false otherwise.
+ * Creates a repairMessage of the given kind:
+ * 8 withdraw, 9 withdrawDone, 10 rejoin or 11 query, see handleRepairMessage().
  */
-bool compareLayers(int l1, int l2) {
-    return l1 < l2;
+template<typename D, template<typename> class W, typename P>
+repairMessage* BFSNode<D, W, P>::createRepairMessage(short kind) {
+    repairMessage *rMessage = new repairMessage;
+    rMessage->setKind(kind);
+    rMessage->setBitLength(KIND_BITS);
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_REPAIR, 1, sizeof(repairMessage));
+    return rMessage;
+}
+
+/*
+ * Creates the aggregateQueryMessage (kind 12) of the current round, for a node at `depth`.
+ */
+template<typename D, template<typename> class W, typename P>
+aggregateQueryMessage* BFSNode<D, W, P>::createAggregateQuery(int depth) {
+    aggregateQueryMessage *qMessage = new aggregateQueryMessage;
+    qMessage->setKind(12);
+    qMessage->setRound(aggregateRound);
+    qMessage->setDepth(depth);
+    qMessage->setBitLength(KIND_BITS + varintBits(aggregateRound) + varintBits(depth));
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_AGGREGATE, 1, sizeof(aggregateQueryMessage));
+    return qMessage;
+}
+
+/*
+ * Creates an aggregateMessage (kind 13) answering the query of `round` with `a`.
+ */
+template<typename D, template<typename> class W, typename P>
+aggregateMessage* BFSNode<D, W, P>::createAggregateMessage(unsigned int round, const Aggregate& a) {
+    aggregateMessage *aMessage = new aggregateMessage;
+    aMessage->setKind(13);
+    aMessage->setRound(round);
+    a.write(aMessage);
+    aMessage->setBitLength(KIND_BITS + varintBits(round) + a.bits());
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_AGGREGATE, 1, sizeof(aggregateMessage));
+    return aMessage;
+}
+
+/*
+ * Creates the labelMessage (kind 14) of the current round, giving a child the labels from `start` on.
+ */
+template<typename D, template<typename> class W, typename P>
+labelMessage* BFSNode<D, W, P>::createLabelMessage(int start) {
+    labelMessage *lMessage = new labelMessage;
+    lMessage->setKind(14);
+    lMessage->setRound(aggregateRound);
+    lMessage->setStart(start);
+    lMessage->setBitLength(KIND_BITS + varintBits(aggregateRound) + varintBits(start));
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_AGGREGATE, 1, sizeof(labelMessage));
+    return lMessage;
+}
+
+/*
+ * Creates a sweepMessage (kind 16) of the current sweep carrying `distance`, -1 on the way to its source.
+ */
+template<typename D, template<typename> class W, typename P>
+sweepMessage* BFSNode<D, W, P>::createSweepMessage(int distance) {
+    sweepMessage *sMessage = new sweepMessage;
+    sMessage->setKind(16);
+    sMessage->setRound(sweepRound);
+    sMessage->setDistance(distance);
+    sMessage->setBitLength(KIND_BITS + varintBits(sweepRound) + varintBits(distance + 1));
+    if(P::statistics)
+        MemoryAccount::get().add(MEM_AGGREGATE, 1, sizeof(sweepMessage));
+    return sMessage;
+}
+
+/*
+ * Sends layer(my_layer + weight of the link) through `port`, unless that is beyond `maxLayer`:
+ * the neighbour is then outside the radius, or gets a smaller layer from someone else.
+ * A layerMessage never goes to our parent, so it also tells the neighbour that we are in its `other` list;
+ * we remember that for the piggybacked protocol.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::sendLayer(int port) {
+    D layer = my_layer + weights.weight(port);
+    if(P::options && compareLayers(maxLayer, layer))
+        return;
+    if(P::delayed)
+        sendAfter(createLayerMessage(layer), port, layerDelay(port, layer));
+    else
+        sendNow(createLayerMessage(layer), port);
+    announced[port] = true;
+    layersSent++;
+}
+
+/*
+ * Sends our layer through every port except `except`, which is the parent's port, or -1 for none, and the ports that are down.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::broadcastLayer(int except) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_BROADCAST);
+    for(int i = 0; i < gateCount() / 2; i++) {
+        if(i == except || (repairing() && !portUp[i]))
+            continue;
+        sendLayer(i);
+    }
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::sendRepair(short kind, int port) {
+    sendNow(createRepairMessage(kind), port);
+    repairsSent++;
+}
+
+/*
+ * Sends msg through `port` right away, through the transport if the policy allows for bundling.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::sendNow(cMessage *msg, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_SEND);
+    if(P::options)
+        transport.send(msg, port, SIMTIME_ZERO);
+    else
+        send(msg, "port$o", port);
+}
+
+/*
+ * Sends msg through `port` after `delay`, through the transport if the policy allows for bundling.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::sendAfter(cMessage *msg, int port, simtime_t delay) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_SEND);
+    if(P::options)
+        transport.send(msg, port, delay);
+    else
+        sendDelayed(msg, delay, "port$o", port);
+}
+
+/*
+ * Picks the delay of a layerMessage carrying `layer` through `port`.
+ * By default it is uniformly random. The adversarial mode looks at the receiver's current layer instead:
+ * the bigger the improvement the message would bring, the longer it takes. Long paths therefore
+ * arrive first and every node walks down its layers one step at a time, forcing the largest number
+ * of parent changes. Messages that don't improve anything are delivered right away.
+ */
+template<typename D, template<typename> class W, typename P>
+simtime_t BFSNode<D, W, P>::layerDelay(int port, D layer) {
+    if(!P::options || !adversarialDelay)
+        return intuniform(1, 1000);
+    BFSNode *k = check_and_cast<BFSNode*>(gate("port$o", port)->getPathEndGate()->getOwnerModule());
+    double gap = std::min(Distance<D>::toDouble(k->my_layer), (double)nodeCount) - Distance<D>::toDouble(layer);
+    return gap > 0 ? gap : 1;
+}
+
+/*
+ * A neighbour's layer only ever goes down, and every layerMessage is stamped with the time it was created at (`timeFrame`).
+ * So a message is superseded if one created later has already come in through the same port, or one created at
+ * the same time carrying a smaller layer. Otherwise it becomes the newest message seen on the port.
+ * After a failure a layer may go up again, so with `repair` the check is always on and goes by the
+ * sequence number instead: the newest message is the one that counts, whatever its layer.
+ * Returns true if the message is superseded.
+ */
+template<typename D, template<typename> class W, typename P>
+bool BFSNode<D, W, P>::isStale(Message *lMsg, int port) {
+    if(repairing()) {
+        if(lMsg->getSeq() <= lastSeq[port])
+            return true;
+        lastSeq[port] = lMsg->getSeq();
+        return false;
+    }
+    simtime_t t = lMsg->getTimeFrame();
+    if(t < lastTimeFrame[port] || (t == lastTimeFrame[port] && Distance<D>::get(lMsg) >= lastLayer[port]))
+        return true;
+    lastTimeFrame[port] = t;
+    lastLayer[port] = Distance<D>::get(lMsg);
+    return false;
 }
 
 /*
  * We handle received message here using other message handler functions declared above.
  */
-void Node::handleLayerMessage(layerMessage *lMsg) {
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleLayerMessage(Message *lMsg, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_HANDLE_LAYER);
 
-    if(setParent(lMsg)) {     // If setParent return true, which means our layer has been changed
+    if(setParent(lMsg, port)) {     // If setParent return true, which means our layer has been changed
 
-        char bubble_msg[50];
-        sprintf(bubble_msg,"Parent node set to: %s", gate("port$o", parent)->getPathEndGate()->getOwnerModule()->getFullName());
-        bubble(bubble_msg);
-        ackMessage *aMsg = createAckMessage();
-        send(aMsg, "port$o", lMsg->getArrivalGate()->getIndex());
-        for(int i = 0; i < gateCount() / 2; i++) {
-            if(i == parent)
-                continue;
-            else
-                if(DELAYED)
-                    sendDelayed(createLayerMessage(my_layer + 1), intuniform(1, 1000), "port$o", i);
-                else
-                    send(createLayerMessage(my_layer + 1), "port$o", i);
-        }
-    } else {
-        int index = lMsg->getArrivalGate()->getIndex();
-        std::list<int>::const_iterator it = std::find(children.begin(), children.end(), index);
-        Node *k = check_and_cast<Node*>(gate("port$o", index)->getPathEndGate()->getOwnerModule());
+        if(P::gui)
+            bubblePending = true;   // Shown by refreshDisplay(), once per refresh however many times the parent changes
+        parentSeq = lMsg->getSeq();
+        ackMessage *aMsg = createAckMessage(lMsg->getSeq());
+        sendNow(aMsg, port);
+        acksSent++;
+        if(dagMode())
+            resetDagParents();
+        broadcastLayer(parent);
+    } else if(port != parent) {     // Our parent repeats its layer on a query or a rejoin, and an overtaken layer of it may arrive late
+        int index = port;
+        std::list<int>::const_iterator it = findPort(children, index);
 
-        if( getIndex() != k->gate("port$o", k->getParent())->getPathEndGate()->getOwnerModule()->getIndex()) {
+        if(!isParentOf(index)) {
             if(it != children.end())
                 children.erase(it);
-            if(std::find(other.begin(), other.end(), index) == other.end())
+            if(findPort(other, index) == other.end())
                 other.push_back(index);
 
-            rejectMessage *rMsg = createRejectMessage();
-            send(rMsg, "port$o", lMsg->getArrivalGate()->getIndex());
+            if(P::options && piggyback && announced[index]) {
+                rejectsPiggybacked++;           // Our last layer message on this port already told the sender the same thing
+            } else {
+                rejectMessage *rMsg = createRejectMessage();
+                sendNow(rMsg, port);
+                rejectsSent++;
+            }
         }
     }
+    if(dagMode())
+        updateDagParents(lMsg, port);
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_LAYER, 1, sizeof(Message));
     delete lMsg;
 }
 
@@ -177,21 +548,58 @@ void Node::handleLayerMessage(layerMessage *lMsg) {
  * Deletes the index of the port that has received the acknowledge message from the `other` list, if it exists in the list.
  * Adds the index of the port that has received the acknowledge message to `children` list, if it doesn't exist in the list already.
  */
-void Node::handleAckMessage(ackMessage *aMsg) {
-    int index = aMsg->getArrivalGate()->getIndex();
-    std::list<int>::const_iterator it = std::find(other.begin(), other.end(), index);
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleAckMessage(ackMessage *aMsg, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_HANDLE_ACK);
+    int index = port;
+    if(repairing() && aMsg->getSeq() <= epochSeq) {  // For a layer of the previous epoch: the sender has moved on since
+        if(P::statistics)
+            MemoryAccount::get().remove(MEM_ACK, 1, sizeof(ackMessage));
+        delete aMsg;
+        return;
+    }
+    if(repairing() && aMsg->getSeq() <= resetSeq) {
+        /*
+         * The sender took a layer we sent before we lost our route, so its route is gone as well.
+         * A reject for the ack tells it so, see handleRejectMessage().
+         */
+        rejectMessage *rMsg = createRejectMessage(aMsg->getSeq());
+        sendNow(rMsg, port);
+        rejectsSent++;
+        if(P::statistics)
+            MemoryAccount::get().remove(MEM_ACK, 1, sizeof(ackMessage));
+        delete aMsg;
+        return;
+    }
+    std::list<int>::const_iterator it = findPort(other, index);
     if(it != other.end())
         other.erase(it);
 
-    if(std::find(children.begin(), children.end(), index) == children.end())
+    if(findPort(children, index) == children.end())
         children.push_back(index);
+    if(dagMode())
+        dagParents[index] = false;                                  // Its layer is above ours now, and it won't tell us any more
 
-
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_ACK, 1, sizeof(ackMessage));
     delete aMsg;
 }
 
-void Node::handleRejectMessage(rejectMessage *rMsg) {
-    int index = rMsg->getArrivalGate()->getIndex();
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleRejectMessage(rejectMessage *rMsg, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_HANDLE_REJECT);
+    int index = port;
+    /*
+     * A reject for the ack of the layer we took from our parent: it has lost that route since.
+     * Any other reject from our parent answers a layer we sent before we took its own.
+     */
+    if(repairing() && index == parent && rMsg->getSeq() == parentSeq) {
+        orphan(-1);
+        if(P::statistics)
+            MemoryAccount::get().remove(MEM_REJECT, 1, sizeof(rejectMessage));
+        delete rMsg;
+        return;
+    }
     /*
      * Depending on the delay times, sometimes when a node receives a reject message from a node.
      * Sender node might already be the parent node of the receiving node.
@@ -199,36 +607,656 @@ void Node::handleRejectMessage(rejectMessage *rMsg) {
      */
 //    if(index != parent) {
         std::list<int>::const_iterator it;
-        if((it = std::find(children.begin(), children.end(), index)) != children.end())
+        if((it = findPort(children, index)) != children.end())
             children.erase(it);
 
-        if(std::find(other.begin(), other.end(), index) == other.end())
+        if(findPort(other, index) == other.end())
             other.push_back(index);
 //    }
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_REJECT, 1, sizeof(rejectMessage));
+    delete rMsg;
+}
+
+
+/*
+ * The repair works in two waves over the subtree of the node that lost its route (the one
+ * whose parent link went down, or whose parent crashed):
+ *  - withdraw (8): a node that gets it from its parent sets its layer to infinity and withdraws
+ *    its own children; once all of them have answered it confirms with withdrawDone (9).
+ *  - rejoin (10): once the whole subtree has confirmed, none of its nodes holds a layer derived from
+ *    the lost route any more. The rejoin goes back down the same ports, and every node asks its other
+ *    neighbours (its `other` list, mostly) for their layer with a query (11). The layers that come back
+ *    are handled as usual, so the subtree rebuilds itself from its border, and nothing outside of it changes.
+ * Layers are ignored while a node is clearing. Queries, and rejoins that reach a node that isn't
+ * clearing, are answered with our layer if we have one.
+ *
+ * Layers we sent before losing our route may still be in flight. A node that takes one acknowledges
+ * its sequence number, and gets a reject from its new parent instead of becoming its child, which makes
+ * it lose its route in turn (see handleAckMessage() and handleRejectMessage()). Should the root be cut off,
+ * such layers go round until they reach `distanceBound`, the "infinity" of distance-vector protocols.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleRepairMessage(repairMessage *rMsg, int port) {
+    short kind = rMsg->getKind();
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_REPAIR, 1, sizeof(repairMessage));
     delete rMsg;
+
+    switch(kind) {
+    case 8:                                                         // withdraw
+        if(port == parent)
+            orphan(port);
+        else
+            sendRepair(9, port);                                    // Not our parent (any more): nothing below us to withdraw
+        break;
+    case 9: {                                                       // withdrawDone
+        if(!clearing)
+            break;
+        std::list<int>::iterator it = findPort(withdrawPending, port);
+        if(it != withdrawPending.end()) {
+            withdrawPending.erase(it);
+            if(withdrawPending.empty())
+                finishWithdraw();
+        }
+    } break;
+    case 10:                                                        // rejoin
+        if(clearing && port == withdrawFrom)
+            rejoin();
+        else if(!clearing && !relabelPending && compareLayers(my_layer, Distance<D>::infinity()))
+            sendLayer(port);                                        // We weren't withdrawn after all: act as a query
+        break;
+    case 11:                                                        // query; after a pending relabel the layer goes to everyone anyway
+        if(!clearing && !relabelPending && compareLayers(my_layer, Distance<D>::infinity()))
+            sendLayer(port);
+        break;
+    }
+}
+
+/*
+ * We have lost our route to the root: through the failed link behind our parent's port (from == -1),
+ * or because our parent lost its own and withdrew us (from == its port).
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::orphan(int from) {
+    orphanings++;
+    resetSeq = layerSeq;
+    relabelPending = false;
+    treePorts.clear();
+    my_layer = Distance<D>::infinity();
+    parent = -1;
+    if(dagMode())
+        resetDagParents();
+    lastChange = simTime();
+    clearing = true;
+    withdrawFrom = from;
+    withdrawn.splice(withdrawn.end(), children);
+    withdrawPending = withdrawn;
+    for(std::list<int>::const_iterator it = withdrawn.begin(); it != withdrawn.end(); it++)
+        sendRepair(8, *it);
+    if(withdrawPending.empty())
+        finishWithdraw();
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::finishWithdraw() {
+    if(withdrawFrom == -1)
+        rejoin();
+    else
+        sendRepair(9, withdrawFrom);
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::rejoin() {
+    clearing = false;
+    withdrawFrom = -1;
+    for(std::list<int>::const_iterator it = withdrawn.begin(); it != withdrawn.end(); it++)
+        sendRepair(10, *it);
+    for(int i = 0; i < (int)portUp.size(); i++)
+        if(portUp[i] && findPort(withdrawn, i) == withdrawn.end())
+            sendRepair(11, i);
+    withdrawn.clear();
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::resetState() {
+    resetSeq = layerSeq;
+    my_layer = Distance<D>::infinity();
+    parent = -1;
+    if(dagMode())
+        resetDagParents();
+    children.clear();
+    other.clear();
+    clearing = false;
+    withdrawFrom = -1;
+    withdrawn.clear();
+    withdrawPending.clear();
+    relabelPending = false;
+    treePorts.clear();
+    announced.assign(announced.size(), false);
+    lastTimeFrame.assign(lastTimeFrame.size(), -1);
+    lastLayer.assign(lastLayer.size(), Distance<D>::infinity());
+    lastSeq.assign(lastSeq.size(), 0);
+}
+
+/*
+ * Everything the node knew is lost; messages that reach it from now on are dropped in handleMessage().
+ * The neighbours find out through linkDown(), after the FailureInjector's detection delay.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::crash() {
+    Enter_Method_Silent();
+    crashed = true;
+    portUp.assign(portUp.size(), false);
+    if(P::options)
+        transport.reset(-1);                                        // What it hasn't sent yet dies with it
+    resetState();
+    routes.clear();
+    lastChange = -1;
+    if(P::gui && getEnvir()->isGUI())
+        getDisplayString().setTagArg("i", 1, "black");
+}
+
+/*
+ * The node comes back as if it had just been created, the root with layer 0.
+ * Being the root and the epoch are configuration, which a restart keeps.
+ * Its ports are brought up one by one with linkUp().
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::restart() {
+    Enter_Method_Silent();
+    crashed = false;
+    resetState();
+    if(root) {
+        my_layer = Distance<D>::zero();
+        lastChange = simTime();
+    }
+    if(P::gui && getEnvir()->isGUI())
+        getDisplayString().setTagArg("i", 1, root ? "red" : "");
+}
+
+/*
+ * Forgets the neighbour behind `port`. If it was our parent, the repair starts here, see orphan().
+ * While clearing, a withdrawn child we lose no longer has to confirm, and if we lose the node we
+ * report to, nobody will send us the rejoin: we finish the repair of our part ourselves.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::linkDown(int port) {
+    Enter_Method_Silent();
+    portUp[port] = false;
+    if(P::options)
+        transport.reset(port);
+    std::list<int>::iterator it;
+    children.remove(port);
+    other.remove(port);                                             // setParent() may have put it there twice
+    if(relabelPending) {
+        treePorts.remove(port);
+        if(candidate == port)
+            candidate = -1;
+        if(treePorts.empty())                                       // The relabel can't come any more
+            finishRelabel(candidate, candidateLayer, candidateSeq);
+    }
+    std::list<int>::iterator pending = findPort(aggregatePending, port);
+    if(pending != aggregatePending.end()) {                         // Its aggregate won't come; the round goes on without it
+        aggregatePending.erase(pending);
+        if(aggregatePending.empty())
+            finishAggregation();
+    }
+    if(clearing) {
+        bool waiting = !withdrawPending.empty();
+        if((it = findPort(withdrawn, port)) != withdrawn.end())
+            withdrawn.erase(it);
+        if((it = findPort(withdrawPending, port)) != withdrawPending.end())
+            withdrawPending.erase(it);
+        if(port == withdrawFrom)
+            withdrawFrom = -1;
+        if(withdrawPending.empty() && (waiting || withdrawFrom == -1))
+            finishWithdraw();
+    }
+    if(dagMode())
+        dagParents[port] = false;
+    if(port == parent && !(dagMode() && failover()))
+        orphan(-1);
+}
+
+/*
+ * Messages still in flight from before the failure are dropped on arrival (see handleMessage()),
+ * so both ends start over on this port: each one sends its layer, if it has one, and the usual
+ * handling sorts out who is whose parent.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::linkUp(int port) {
+    Enter_Method_Silent();
+    portUp[port] = true;
+    portUpSince[port] = simTime();
+    announced[port] = false;
+    lastTimeFrame[port] = -1;
+    lastLayer[port] = Distance<D>::infinity();
+    lastSeq[port] = 0;
+    if(!crashed && !clearing && !relabelPending && compareLayers(my_layer, Distance<D>::infinity()))
+        sendLayer(port);
+}
+
+/*
+ * Moves the root here without building the tree again. A new epoch starts, and our layer of 0 goes out
+ * as usual. Every node then waits for its relabel: the first layer of the new epoch to come over one of
+ * its old tree links, i.e. from its old parent or, along the path from here to the old root, from an old
+ * child. The relabel alone gives it a layer no larger than the one over the reversed tree, so it becomes
+ * the parent; a better layer from elsewhere that came first (`candidate`) wins instead. Only then does the
+ * node announce its layer, once, and the usual handling improves on it where the old tree doesn't make a
+ * shortest-path tree for the new root. Nodes whose layer and parent stay the same don't count as changed.
+ * With `coldReroot` nodes forget their tree on entering the epoch: the full rebuild, to compare with.
+ * One reroot at a time, on a tree that has settled.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::reroot() {
+    Enter_Method_Silent();
+    if(crashed || root)
+        return;
+    enterEpoch(epoch + 1);
+    root = true;
+    relabelPending = false;
+    treePorts.clear();
+    if(parent != -1 || !(my_layer == Distance<D>::zero())) {
+        my_layer = Distance<D>::zero();
+        lastChange = simTime();
+        if(P::statistics)
+            layerVector.record(Distance<D>::toDouble(my_layer));
+    }
+    parent = -1;
+    if(dagMode())
+        resetDagParents();
+    if(P::gui && getEnvir()->isGUI())
+        getDisplayString().setTagArg("i", 1, "red");
+    broadcastLayer(-1);
+}
+
+/*
+ * Leaves the tree of the previous epoch: we remember our links in it and wait for the relabel over one of them.
+ * Without a layer, or with `coldReroot`, there is nothing to wait for and we start over like a new node.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::enterEpoch(unsigned int e) {
+    if(root && P::gui && getEnvir()->isGUI())
+        getDisplayString().setTagArg("i", 1, "");
+    root = false;
+    epoch = e;
+    epochSeq = layerSeq;
+    treePorts.clear();
+    if(!coldReroot && compareLayers(my_layer, Distance<D>::infinity())) {
+        treePorts = children;
+        if(parent != -1)
+            treePorts.push_back(parent);
+    }
+    children.clear();
+    other.clear();
+    clearing = false;
+    withdrawFrom = -1;
+    withdrawn.clear();
+    withdrawPending.clear();
+    announced.assign(announced.size(), false);
+    candidate = -1;
+    relabelPending = !treePorts.empty();
+    if(!relabelPending && compareLayers(my_layer, Distance<D>::infinity())) {
+        my_layer = Distance<D>::infinity();
+        parent = -1;
+        lastChange = simTime();
+    }
+    if(dagMode())
+        resetDagParents();                                          // Alternatives of the old tree are no use in the new one
+}
+
+/*
+ * A layer of the new epoch before our relabel. Layers from off the old tree are only kept as the candidate;
+ * all but the best one get their reject right away, since none of them has made us a child yet.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::relabel(Message *lMsg, int port) {
+    D layer = Distance<D>::get(lMsg);
+    int rejected = -1;
+    if(findPort(treePorts, port) != treePorts.end()) {
+        if(candidate != -1 && compareLayers(candidateLayer, layer)) {
+            rejected = port;
+            finishRelabel(candidate, candidateLayer, candidateSeq);
+        } else {
+            rejected = candidate;
+            finishRelabel(port, layer, lMsg->getSeq());
+        }
+    } else if(candidate == -1 || compareLayers(layer, candidateLayer)) {
+        rejected = candidate;
+        candidate = port;
+        candidateLayer = layer;
+        candidateSeq = lMsg->getSeq();
+    } else {
+        rejected = port;
+    }
+    if(rejected != -1) {
+        rejectMessage *rMsg = createRejectMessage();
+        sendNow(rMsg, rejected);
+        rejectsSent++;
+    }
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_LAYER, 1, sizeof(Message));
+    delete lMsg;
+}
+
+/*
+ * Ends the wait for the relabel with the layer that came through `port`, or with no layer at all if `port` is -1.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::finishRelabel(int port, D layer, unsigned int seq) {
+    relabelPending = false;
+    treePorts.clear();
+    candidate = -1;
+    if(port == -1)
+        layer = Distance<D>::infinity();
+    if(port != parent && port != -1)
+        parentChanges++;
+    if(port != parent || !(layer == my_layer)) {
+        lastChange = simTime();
+        if(P::statistics)
+            layerVector.record(Distance<D>::toDouble(layer));
+    }
+    my_layer = layer;
+    parent = port;
+    if(dagMode())
+        resetDagParents();
+    if(port == -1)
+        return;
+    parentSeq = seq;
+    ackMessage *aMsg = createAckMessage(seq);
+    sendNow(aMsg, port);
+    acksSent++;
+    broadcastLayer(parent);
+}
+
+/*
+ * Starts a round of the aggregation at the root: a query goes down the tree, one message per child,
+ * and every node answers its parent with a single aggregateMessage once all of its children have.
+ * With `aggregation = "flood"` the query goes through every link instead (an echo, 2 messages per link):
+ * the first copy a node gets decides its parent for the round, the other copies are answered with an
+ * empty aggregate. The depths of such a round are those of the echo's tree rather than the BFS tree.
+ * Rounds don't overlap: a new one only starts once the previous one has ended.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::startAggregation() {
+    Enter_Method_Silent();
+    if(!root || crashed || !aggregatePending.empty())
+        return;
+    aggregateStarted = simTime();
+    joinAggregation(aggregateRound + 1, -1, 0);
+}
+
+/*
+ * A query we don't take, because it isn't from our parent or we already have one for its round,
+ * is answered right away with an empty aggregate, so that the sender doesn't wait for us.
+ * Our `children` list may still hold a neighbour that has become our parent, which is what the
+ * first case is for.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleAggregateQuery(aggregateQueryMessage *qMsg, int port) {
+    unsigned int round = qMsg->getRound();
+    int depth = qMsg->getDepth();
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_AGGREGATE, 1, sizeof(aggregateQueryMessage));
+    delete qMsg;
+
+    if(round > aggregateRound && ((P::options && floodAggregation) || port == parent)) {
+        joinAggregation(round, port, depth);
+    } else {
+        sendAfter(createAggregateMessage(round, Aggregate()), port, P::delayed ? intuniform(1, 1000) : 0);
+        aggregationsSent++;
+    }
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleAggregateMessage(aggregateMessage *aMsg, int port) {
+    std::list<int>::iterator it = findPort(aggregatePending, port);
+    if(aMsg->getRound() == aggregateRound && it != aggregatePending.end()) {
+        if(aggregate.merge(aMsg))
+            deepestPort = port;
+        if(P::options && routing && aMsg->getCount() > 0)           // The empty ones are from neighbours that aren't our children
+            aggregateSubtrees.push_back(std::make_pair(port, aMsg->getCount()));
+        aggregatePending.erase(it);
+        if(aggregatePending.empty())
+            finishAggregation();
+    }
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_AGGREGATE, 1, sizeof(aggregateMessage));
+    delete aMsg;
+}
+
+/*
+ * Starts our aggregate with our own value and sends the query to our children, or in flood mode to all
+ * our neighbours but the one it came from. Like layers, queries and aggregates take a random delay.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::joinAggregation(unsigned int round, int from, int depth) {
+    aggregateRound = round;
+    aggregateFrom = from;
+    aggregate = Aggregate();
+    aggregate.add(aggregateValue, depth, getIndex(), sweepDistance);
+    deepestPort = -1;
+    aggregatePending.clear();
+    aggregateSubtrees.clear();
+    for(int i = 0; i < gateSize("port"); i++) {
+        if(i == from || !isPortUp(i) || (!(P::options && floodAggregation) && findPort(children, i) == children.end()))
+            continue;
+        sendAfter(createAggregateQuery(depth + 1), i, P::delayed ? intuniform(1, 1000) : 0);
+        aggregationsSent++;
+        aggregatePending.push_back(i);
+    }
+    if(aggregatePending.empty())
+        finishAggregation();
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::finishAggregation() {
+    if(aggregateFrom != -1) {
+        sendAfter(createAggregateMessage(aggregateRound, aggregate), aggregateFrom, P::delayed ? intuniform(1, 1000) : 0);
+        aggregationsSent++;
+        return;
+    }
+    aggregateRoundsDone++;
+    aggregateLatency += simTime() - aggregateStarted;
+    treeDepth = aggregate.depths.size() - 1;
+    if(P::options && routing)
+        assignLabels(0);
+    if(P::options && diameter && sweepSource == -1)
+        startSweep();
+    if(aggregateTimer && --aggregateRoundsLeft > 0)
+        scheduleAt(simTime() + aggregateInterval, aggregateTimer);
+}
+
+/*
+ * The labels of a round only come from the node whose query we took in it; anything else is from
+ * a round we didn't take part in, or a parent we don't have any more.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleLabelMessage(labelMessage *lMsg, int port) {
+    if(lMsg->getRound() == aggregateRound && port == aggregateFrom)
+        assignLabels(lMsg->getStart());
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_AGGREGATE, 1, sizeof(labelMessage));
+    delete lMsg;
+}
+
+/*
+ * Interval labelling of the tree of the round that has just ended: we take `start`, and our subtree,
+ * whose size the round has told us, the labels up to start + size. The rest of them is handed to our
+ * children one interval after the other, in the order their aggregates came in, which keeps the
+ * table sorted by start. One labelMessage per tree link, so a labelling costs N - 1 messages.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::assignLabels(int start) {
+    routes.label = start;
+    routes.end = start + aggregate.count;
+    routes.up = aggregateFrom;
+    routes.down.clear();
+    int next = start + 1;
+    for(size_t i = 0; i < aggregateSubtrees.size(); i++) {
+        int port = aggregateSubtrees[i].first;
+        RoutingTable::Range range = { next, next + (int)aggregateSubtrees[i].second, port };
+        routes.down.push_back(range);
+        sendAfter(createLabelMessage(next), port, P::delayed ? intuniform(1, 1000) : 0);
+        aggregationsSent++;
+        next = range.end;
+    }
+}
+
+/*
+ * A packet for us goes to the TrafficGenerator, any other one one hop further through the port of our
+ * table. Tables from different labellings may disagree while a new one is on its way, or after the tree
+ * has been repaired, so a packet is dropped after as many hops as there are nodes.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::route(dataMessage *dMsg) {
+    int port = routes.label < 0 ? -1 : routes.lookup(dMsg->getDestination());
+    if(dagMode() && port != -1 && port == routes.up && port == parent)
+        port = nextDagParent();                                     // Any of them is one hop closer to the root
+    if(port == RoutingTable::LOCAL) {
+        if(traffic)
+            traffic->packetDelivered(dMsg);
+        delete dMsg;
+    } else if(port < 0 || !isPortUp(port) || dMsg->getHops() >= nodeCount) {
+        packetsDropped++;
+        delete dMsg;
+    } else {
+        dMsg->setHops(dMsg->getHops() + 1);
+        sendNow(dMsg, port);
+        packetsForwarded++;
+    }
 }
 
+/*
+ * Entry point of the TrafficGenerator: the packet starts here.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::sendData(dataMessage *msg) {
+    Enter_Method_Silent();
+    take(msg);
+    route(msg);
+}
 
+/*
+ * Double sweep: the deepest node of the round that has just ended is as far from us as any node gets,
+ * and a second BFS from it (the sweep) reaches the largest distance it can, a lower bound of the
+ * diameter that is often exact. The start goes down the tree along `deepestPort`, and the sweep floods
+ * from there like the layers do, improving on every shorter distance. The rounds that end after it has
+ * settled collect the largest distance, so `aggregateInterval` has to leave it the time.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::startSweep() {
+    sweepSource = aggregate.deepest;
+    sweepRound = aggregateRound;
+    if(deepestPort == -1) {                                         // A tree of one node
+        sweepDistance = 0;
+        return;
+    }
+    sendAfter(createSweepMessage(-1), deepestPort, P::delayed ? intuniform(1, 1000) : 0);
+    aggregationsSent++;
+}
+
+/*
+ * Every sweep has its own round, so a node forgets the distance of the previous one when it first
+ * hears of a new one. Distances are in hops, whatever the metric of the tree.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::handleSweepMessage(sweepMessage *sMsg, int port) {
+    unsigned int round = sMsg->getRound();
+    int distance = sMsg->getDistance();
+    if(P::statistics)
+        MemoryAccount::get().remove(MEM_AGGREGATE, 1, sizeof(sweepMessage));
+    delete sMsg;
+
+    if(round < sweepRound)
+        return;
+    if(round > sweepRound) {
+        sweepRound = round;
+        sweepDistance = -1;
+    }
+    int from = port;
+    if(distance == -1) {                                            // The start, on its way to the source
+        if(deepestPort != -1) {
+            sendAfter(createSweepMessage(-1), deepestPort, P::delayed ? intuniform(1, 1000) : 0);
+            aggregationsSent++;
+            return;
+        }
+        distance = 0;
+        from = -1;
+    }
+    if(sweepDistance != -1 && sweepDistance <= distance)
+        return;
+    sweepDistance = distance;
+    for(int i = 0; i < gateSize("port"); i++) {
+        if(i == from || !isPortUp(i))
+            continue;
+        sendAfter(createSweepMessage(distance + 1), i, P::delayed ? intuniform(1, 1000) : 0);
+        aggregationsSent++;
+    }
+}
+
+/*
+ * Brings the account up to date with our list entries and the length of the future event set.
+ * A list entry is an int plus the two links of the list node.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::updateMemoryAccount() {
+    struct ListEntry { void *prev, *next; int port; };
+    MemoryAccount& account = MemoryAccount::get();
+    long entries = children.size() + other.size();
+    if(entries != accountedEntries) {
+        account.add(MEM_LIST_ENTRIES, entries - accountedEntries, (entries - accountedEntries) * (int64_t)sizeof(ListEntry));
+        accountedEntries = entries;
+    }
+    long fes = getSimulation()->getFES()->getLength();
+    account.set(MEM_FES, fes, fes * (int64_t)sizeof(cEvent *));
+}
+
+/*
+ * Whether the neighbour behind `port` has us as its parent. Looks into the other module,
+ * which a real node couldn't do; the answer only saves a reject the neighbour would ignore.
+ */
+template<typename D, template<typename> class W, typename P>
+bool BFSNode<D, W, P>::isParentOf(int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_PARENT_CHECK);
+    BFSNode *k = check_and_cast<BFSNode*>(gate("port$o", port)->getPathEndGate()->getOwnerModule());
+    return getIndex() == k->getParentNode();
+}
+
+/*
+ * std::find of `port` in the children or other list.
+ */
+template<typename D, template<typename> class W, typename P>
+std::list<int>::iterator BFSNode<D, W, P>::findPort(std::list<int>& ports, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_LIST_SEARCH);
+    return std::find(ports.begin(), ports.end(), port);
+}
 
 /*
  * Compares the layer value of a layerMessage with the node's actual layer.
  * If the layer value from the message is smaller, then my_layer variable is set to the layer value from the received message.
  * Returns true if layer value has been changed, false otherwise.
  */
-bool Node::setParent(layerMessage *lMsg) {
-    if(compareLayers(lMsg->getLayer(), my_layer)) {     // If my_layer is greater than the layer in the received message,
-        if(parent != -1) {
-            undoParentPathColor();
+template<typename D, template<typename> class W, typename P>
+bool BFSNode<D, W, P>::setParent(Message *lMsg, int port) {
+    ProfileScope<P::profiling> scope(profiler, PROFILE_SET_PARENT);
+    if(compareLayers(Distance<D>::get(lMsg), my_layer)) {     // If my_layer is greater than the layer in the received message,
+        if(parent != -1)
             other.push_back(parent);
-        }
-        my_layer = lMsg->getLayer();                    // change my_layer to layer in the received message
-        parent = lMsg->getArrivalGate()->getIndex();    // Change parent to the index of the port that the message has arrived through.
+        my_layer = Distance<D>::get(lMsg);              // change my_layer to layer in the received message
+        parentChanges++;
+        lastChange = simTime();
+        if(P::statistics)
+            layerVector.record(Distance<D>::toDouble(my_layer));
+        parent = port;                                  // Change parent to the index of the port that the message has arrived through.
         std::list<int>::const_iterator it;
 
-        if((it = std::find(other.begin(), other.end(), parent)) != other.end())
+        if((it = findPort(other, parent)) != other.end())
             other.erase(it);
+        if((it = findPort(children, parent)) != children.end())
+            children.erase(it);                         // Its layer is below ours now, so it has taken another parent since its ack
 
-        setParentPathColor();
         return true;
     }
 
@@ -236,22 +1264,117 @@ bool Node::setParent(layerMessage *lMsg) {
 }
 
 /*
- * Changes the color of the path which is connected to parent node back to default.
- * We are using this if our parent node has changed, which means we need to update our path colors as well.
+ * In DAG mode, a layer equal to ours makes its sender one more parent (all of them are on a shortest path).
+ * A larger one from a parent means that its layer has gone up, which only a repair does; without the repair,
+ * layers from the same neighbour only ever go down, so a larger one is older than the one we kept, and the
+ * sender stays a parent. A smaller one has made its sender our parent in setParent() already.
+ * A neighbour that has become our child is dropped on its ack, see handleAckMessage().
+ * Layers that came while we waited for a relabel aren't looked at, so after a reroot the set may miss some.
  */
-void Node::undoParentPathColor() {
-    gate("port$o", parent)->getDisplayString().parse("ls=black,1");
-    int index = gate("port$o", parent)->getPathEndGate()->getIndex();
-    gate("port$o", parent)->getPathEndGate()->getOwnerModule()->gate("port$o", index)->getDisplayString().parse("ls=black,1");
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::updateDagParents(Message *lMsg, int port) {
+    if(port == parent || !compareLayers(my_layer, Distance<D>::infinity()) || findPort(children, port) != children.end())
+        return;                                                     // A child's layers are from before it took us as parent
+    if(Distance<D>::get(lMsg) == my_layer)
+        dagParents[port] = true;
+    else if(repairing())
+        dagParents[port] = false;
 }
 
-void Node::setParentPathColor() {
-    gate("port$o", parent)->getDisplayString().parse("ls=red,3");
-    int index = gate("port$o", parent)->getPathEndGate()->getIndex();
-    gate("port$o", parent)->getPathEndGate()->getOwnerModule()->gate("port$o", index)->getDisplayString().parse("ls=red,3");
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::resetDagParents() {
+    dagParents.assign(dagParents.size(), false);
+    if(parent != -1)
+        dagParents[parent] = true;
 }
 
-void Node::hideOtherNodes() {
+/*
+ * Our parent is gone, but another neighbour offers the same layer: it becomes the parent, with the ack
+ * of the layer we had from it. Nothing changes for our subtree, so there is no withdraw. If that
+ * neighbour has lost its route in the meantime, its reject for the ack orphans us as usual.
+ */
+template<typename D, template<typename> class W, typename P>
+bool BFSNode<D, W, P>::failover() {
+    int port = -1;
+    for(int i = 0; i < (int)dagParents.size() && port == -1; i++)
+        if(dagParents[i] && isPortUp(i))
+            port = i;
+    if(port == -1)
+        return false;
+    failovers++;
+    parent = port;
+    parentSeq = lastSeq[port];
+    other.remove(port);
+    ackMessage *aMsg = createAckMessage(parentSeq);
+    sendNow(aMsg, port);
+    acksSent++;
+    if(P::gui)
+        bubblePending = true;
+    return true;
+}
+
+/*
+ * Round robin over our parents, starting after the one used last; our parent if there is no other.
+ */
+template<typename D, template<typename> class W, typename P>
+int BFSNode<D, W, P>::nextDagParent() {
+    int ports = dagParents.size();
+    for(int k = 1; k <= ports; k++) {
+        int i = (dagNext + k) % ports;
+        if(dagParents[i] && isPortUp(i))
+            return dagNext = i;
+    }
+    return parent;
+}
+
+/*
+ * Called by Qtenv once per screen refresh, never in Cmdenv. Parent changes since the last refresh
+ * only moved `parent`; the link colours catch up here in one go, from the path drawn last time
+ * straight to the current one, and at most one bubble is shown for all of them.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::refreshDisplay() const {
+    if(!P::gui || linkGates.empty())
+        return;
+    if(shownParent != parent) {
+        if(shownParent != -1)
+            setLinkStyle(shownParent, "black", 1);
+        if(parent != -1)
+            setLinkStyle(parent, "red", 3);
+        shownParent = parent;
+    }
+    if(bubblePending && parent != -1) {
+        char bubble_msg[50];
+        snprintf(bubble_msg, sizeof(bubble_msg), "Parent node set to: %s", linkGates[2 * parent + 1]->getOwnerModule()->getFullName());
+        showBubble(bubble_msg);
+    }
+    bubblePending = false;
+}
+
+/*
+ * Sets the line of the link behind `port`, in both directions. Only the `ls` tag is touched,
+ * so the display strings aren't parsed again.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::setLinkStyle(int port, const char *colour, long width) const {
+    for(int k = 0; k < 2; k++) {
+        cDisplayString& ds = linkGates[2 * port + k]->getDisplayString();
+        ds.setTagArg("ls", 0, colour);
+        ds.setTagArg("ls", 1, width);
+    }
+}
+
+/*
+ * Shows a bubble if the network-wide limiter lets it through, see gui_refresh.h.
+ */
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::showBubble(const char *text) const {
+    if(!getEnvir()->isExpressMode() && BubbleLimiter::get().allow(maxBubbles, bubbleWindow))
+        bubble(text);
+}
+
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::hideOtherNodes() {
     std::list<int>::const_iterator it = other.begin();
     for(; it != other.end(); it++) {
         gate("port$o", *it)->getDisplayString().parse("ls=,0");
@@ -262,7 +1385,8 @@ void Node::hideOtherNodes() {
 /*
  * Prints out the parent node.
  */
-void Node::printParentNode() {
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::printParentNode() {
     if(parent != -1)
         EV << getFullName() << "'s parent node is: " << gate("port$o", parent)->getPathEndGate()->getOwnerModule()->getFullName() << std::endl;
 }
@@ -270,7 +1394,8 @@ void Node::printParentNode() {
 /*
  * Prints out children nodes iterating over children vector.
  */
-void Node::printChildrenNodes() {
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::printChildrenNodes() {
     EV << getFullName();
     if(!children.empty()) {
         EV << "'s children nodes are:" << std::endl;
@@ -284,7 +1409,8 @@ void Node::printChildrenNodes() {
 /*
  * Prints out other nodes iterating over other vector.
  */
-void Node::printOtherNodes() {
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::printOtherNodes() {
     EV << getFullName();
     if(other.begin() != other.end()) {
         EV << "'s other nodes are: " << std::endl;
@@ -295,19 +1421,90 @@ void Node::printOtherNodes() {
     }
 }
 
-void Node::printLayer() {
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::printLayer() {
     EV << getFullName() << "'s layer is: " << my_layer << std::endl;
 }
 
 /*
- * When the simulation ends we print out all the information from nodes.
- * So that we see whose parent is who and etc.
+ * When the simulation ends we record how many messages of each type the node has sent,
+ * and print out all the information from nodes if `printTree` is set.
+ * The resulting tree is exported in bulk by the TreeExporter module, so this is off by default.
  */
-void Node::finish() {
+template<typename D, template<typename> class W, typename P>
+void BFSNode<D, W, P>::finish() {
 //    hideOtherNodes();
+    if(P::statistics) {
+        recordScalar("parentChanges", parentChanges);
+        recordScalar("layersSent", layersSent);
+        recordScalar("acksSent", acksSent);
+        recordScalar("rejectsSent", rejectsSent);
+        recordScalar("rejectsPiggybacked", rejectsPiggybacked);
+        recordScalar("staleLayersDropped", staleLayersDropped);
+        recordScalar("bundlesSent", transport.bundlesSent);
+        recordScalar("messagesBundled", transport.messagesBundled);
+        recordScalar("peakFesLength", peakFesLength);
+        if(lastChange >= SIMTIME_ZERO)
+            recordScalar("convergenceTime", lastChange);
+        recordScalar("bitsSent", transport.bitsSent);
+        recordScalar("txQueued", transport.txQueued);
+        recordScalar("txQueueingDelay", transport.txQueueingDelay);
+        recordScalar("messagesLost", transport.messagesLost);
+        recordScalar("retransmissions", transport.retransmissions);
+        recordScalar("retransmitsAbandoned", transport.retransmitsAbandoned);
+        recordScalar("linkAcksSent", transport.linkAcksSent);
+        recordScalar("duplicatesDropped", transport.duplicatesDropped);
+        if(aggregateRound > 0)
+            recordScalar("aggregationsSent", aggregationsSent);
+        if(dagMode()) {
+            recordScalar("dagParents", std::count(dagParents.begin(), dagParents.end(), true));
+            recordScalar("failovers", failovers);
+        }
+        if(routing) {
+            recordScalar("packetsForwarded", packetsForwarded);
+            recordScalar("packetsDropped", packetsDropped);
+        }
+        if(repairing()) {
+            recordScalar("repairsSent", repairsSent);
+            recordScalar("orphanings", orphanings);
+            recordScalar("failureDrops", failureDrops);
+        }
+    }
+    profiler.record(this);
+    if(aggregateRoundsDone > 0) {
+        recordScalar("aggregateRounds", aggregateRoundsDone);
+        recordScalar("aggregateLatency", aggregateLatency / aggregateRoundsDone);
+        recordScalar("aggregateCount", aggregate.count);
+        recordScalar("aggregateSum", aggregate.sum);
+        recordScalar("aggregateMin", aggregate.min);
+        recordScalar("aggregateMax", aggregate.max);
+        for(size_t d = 0; d < aggregate.depths.size(); d++) {
+            char name[32];
+            snprintf(name, sizeof(name), "nodesAtDepth%d", (int)d);
+            recordScalar(name, aggregate.depths[d]);
+        }
+        recordScalar("treeDepth", treeDepth);
+        recordScalar("deepestNode", aggregate.deepest);
+        if(diameter && aggregate.sweep >= 0) {
+            recordScalar("sweepSource", sweepSource);
+            recordScalar("diameterEstimate", std::max(aggregate.sweep, treeDepth));
+            recordScalar("diameterUpperBound", 2 * treeDepth);
+        }
+    }
+
+    if(!par("printTree").boolValue())
+        return;
     EV << "============" << getFullName() << "============" << std::endl;
     printParentNode();
     printChildrenNodes();
     printOtherNodes();
     printLayer();
 }
+
+template class BFSNode<int, UnitWeight, DefaultPolicy>;
+template class BFSNode<int, UnitWeight, ImmediatePolicy>;
+template class BFSNode<int, UnitWeight, FastPolicy>;
+template class BFSNode<short, UnitWeight, FastPolicy>;
+template class BFSNode<int, UnitWeight, ProfilingPolicy>;
+template class BFSNode<double, LinkDelayWeight, DefaultPolicy>;
+template class BFSNode<FixedCost, LinkCostWeight, DefaultPolicy>;
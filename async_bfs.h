@@ -0,0 +1,270 @@
+/*
+ * async_bfs.h
+ *
+ *  Created on: Nov 6, 2019
+ *      Author: burak
+ */
+
+#ifndef ASYNC_BFS_H_
+#define ASYNC_BFS_H_
+
+#include <omnetpp.h>
+#include <cmath>
+#include <list>
+#include <vector>
+#include "ack_m.h"
+#include "layer_m.h"
+#include "reject_m.h"
+#include "repair_m.h"
+#include "aggregate_query_m.h"
+#include "aggregate.h"
+#include "label_m.h"
+#include "sweep_m.h"
+#include "data_m.h"
+#include "routing_table.h"
+#include "link_transport.h"
+#include "metric.h"
+#include "policy.h"
+#include "gui_refresh.h"
+#include "profiler.h"
+#include "memory_monitor.h"
+
+using namespace omnetpp;
+
+class TrafficGenerator;
+
+/*
+ * The part of a BFS node that doesn't depend on the distance type: who is connected through
+ * which port, and where the node sits in the tree. Exporters and checkers go through this.
+ */
+class TreeNode : public cSimpleModule {
+protected:
+    std::list<int> children;    // List to keep our children nodes
+    std::list<int> other;       // List to keep our other nodes
+    std::vector<int> neighbours;// Index of the node at the other end of each port, resolved once in initialize()
+    int parent = -1;            // Parent is set to -1 initially which will let us distinguish which nodes have parents and not.
+    simtime_t lastChange = -1;  // When the node got its current layer, -1 if it never got one
+    bool repair = false;        // Failures are scheduled in this run (see FailureInjector): the repair rules are on
+    bool coldReroot = false;    // A reroot floods the network from scratch instead of reusing the tree
+    bool root = false;          // We are the root of the current epoch; node[0] until a reroot
+    bool crashed = false;       // Down since crash(), until restart()
+    std::vector<bool> portUp;   // Whether the link behind each port is up; only kept with `repair`
+    std::vector<bool> dagParents;   // Ports of every neighbour on a shortest path to the root, the parent's included; only kept with `dag`
+    Aggregate aggregate;        // Of our subtree, from the latest aggregation round we took part in
+    RoutingTable routes;        // Next hops over the tree of the latest labelling we took part in
+public:
+    int getParent() const { return parent; }                                // Port index of the parent, -1 if none
+    int getParentNode() const { return parent == -1 ? -1 : neighbours[parent]; }  // Node index of the parent, -1 if none
+    int getNeighbour(int port) const { return neighbours[port]; }          // Node index at the other end of the given port
+    const std::list<int>& getChildren() const { return children; }          // Port indices of the children
+    virtual double getDistance() const = 0;                                 // Distance from the root, infinity if not reached
+    simtime_t getLastChangeTime() const { return lastChange; }             // Time of the last layer change, -1 if not reached
+
+    void enableRepair(bool cold) { repair = true; coldReroot = cold; }      // Before init stage 1, by the FailureInjector
+    bool isRoot() const { return root; }
+    bool isCrashed() const { return crashed; }
+    bool isPortUp(int port) const { return portUp.empty() || portUp[port]; }
+    bool hasDag() const { return !dagParents.empty(); }
+    bool isDagParent(int port) const { return !dagParents.empty() && dagParents[port]; }  // Whether `port` leads to one of our equal-distance parents
+    virtual void crash() = 0;                                               // Stops the node and forgets its state
+    virtual void restart() = 0;                                             // Brings it back with an empty state; its ports stay down
+    virtual void linkDown(int port) = 0;                                    // The link behind `port` has failed (or its far end crashed)
+    virtual void linkUp(int port) = 0;                                      // The link behind `port` works again
+    virtual void reroot() = 0;                                              // Makes this node the root of a new epoch
+    virtual long getMessagesSent() const = 0;                               // Protocol messages sent so far, 0 without statistics
+    virtual double getMaxLayer() const = 0;                                 // Layer limit in effect, -1 if none
+
+    virtual void startAggregation() = 0;                                    // Root: starts a round of the aggregation over the tree
+    const Aggregate& getAggregate() const { return aggregate; }             // Subtree size, sum, min, max and depths, see BFSNode
+    int getLabel() const { return routes.label; }                           // Our label in the routing tables, -1 if none
+    virtual void sendData(dataMessage *msg) = 0;                            // Takes the packet and forwards it towards its destination
+};
+
+/*
+ * Asynchronous BFS (distributed Bellman-Ford) node, generalised over the distance type D,
+ * the source of edge weights W<D> (see metric.h) and the compile-time policy P (see policy.h).
+ * Every instantiation is a separate module type; the hop count one is `Node`.
+ * When failures are scheduled (see FailureInjector), a node that loses its route withdraws its
+ * subtree and only that subtree rebuilds its layers, see orphan(). A reroot relabels the existing
+ * tree from the new root instead of building a new one, see reroot().
+ * Once the tree is built, the root can collect aggregates of the nodes' values over it, see startAggregation(),
+ * and the subtree sizes that come with them label the tree for routing, see assignLabels().
+ */
+template<typename D, template<typename> class W, typename P = DefaultPolicy>
+class BFSNode : public TreeNode {
+    typedef typename Distance<D>::message_type Message;   // layerMessage or distanceMessage
+
+    simtime_t last_creation_time_processed = 0;
+    D my_layer = Distance<D>::infinity();     // When a node is created its layer is set to infinity
+    W<D> weights;                             // Cost of the link behind each port
+    bool piggyback = false;     // Let layer messages stand in for rejects instead of sending a rejectMessage every time
+    std::vector<bool> announced;// Whether we have sent a layerMessage through the port, see broadcastLayer()
+    bool dropStale = false;     // Drop layer messages overtaken by a newer one from the same neighbour, see isStale()
+    bool dag = false;           // Keep every equal-distance parent in `dagParents`, see updateDagParents()
+    bool layerPriority = false; // Layer messages due at the same time are delivered smallest layer first, see createLayerMessage()
+    int dagNext = 0;            // Port after which route() looks for the next parent to send a packet up through
+    std::vector<simtime_t> lastTimeFrame;   // Creation time of the newest layerMessage received through each port
+    std::vector<D> lastLayer;               // and the layer it carried
+    bool adversarialDelay = false;          // Pick layerMessage delays to force the most parent changes, see layerDelay()
+    int nodeCount = 0;                      // Size of the node vector, the longest possible path
+    D maxLayer = Distance<D>::infinity();   // No layerMessage carries more than this: the k-hop neighbourhood of the root
+
+    Counter<P::statistics> parentChanges;       // Number of times setParent() has lowered our layer
+    Counter<P::statistics> layersSent;          // Number of messages of each type sent by this node
+    Counter<P::statistics> acksSent;
+    Counter<P::statistics> rejectsSent;
+    Counter<P::statistics> rejectsPiggybacked;  // Rejects that weren't sent because a layerMessage already carried them
+    Counter<P::statistics> staleLayersDropped;  // Layer messages dropped without running handleLayerMessage()
+    long peakFesLength = 0;                     // Largest future event set length seen by this node
+    cOutVector layerVector;                     // (time, layer) of every parent change
+    Profiler<P::profiling> profiler;            // Calls and cycles per handler, see profiler.h
+    long accountedEntries = 0;                  // children + other entries already in the MemoryAccount
+
+    std::vector<simtime_t> portUpSince;     // When each port last came up; anything created before is from the link's previous life
+    unsigned int layerSeq = 0;              // Sequence number of the last layerMessage we sent
+    unsigned int resetSeq = 0;              // layerSeq when we last lost our route: acks up to it are for layers we no longer have
+    std::vector<unsigned int> lastSeq;      // Newest layerMessage received through each port, by sequence number
+    unsigned int parentSeq = 0;             // That of the layerMessage we took from our parent
+    D distanceBound;                        // Layers from here on are unreachable, see initialize()
+    bool clearing = false;                  // We lost our route and our old subtree is being withdrawn, see orphan()
+    int withdrawFrom = -1;                  // Port of the node whose withdraw orphaned us, -1 if the repair started here
+    std::list<int> withdrawn;               // Ports we sent a withdraw to, which get the rejoin
+    std::list<int> withdrawPending;         // and those of them that haven't confirmed yet
+    unsigned int epoch = 0;                 // Reroots so far; layers of an older epoch are dropped
+    unsigned int epochSeq = 0;              // layerSeq when we entered the epoch: acks up to it are from the old one
+    std::list<int> treePorts;               // Our tree links of the previous epoch, over which the relabel comes
+    bool relabelPending = false;            // We have entered the epoch and wait for the relabel, see relabel()
+    int candidate = -1;                     // Port of the best layer from off the old tree until then
+    D candidateLayer;                       // and its layer
+    unsigned int candidateSeq = 0;          // and the sequence number to acknowledge
+    Counter<P::statistics> repairsSent;     // Withdraw, withdrawDone, rejoin and query messages sent
+    Counter<P::statistics> orphanings;      // Times we lost our route
+    Counter<P::statistics> failureDrops;    // Messages that arrived while we were down or through a link that was down
+    Counter<P::statistics> failovers;       // Times we lost our parent and took another one from `dagParents`
+
+    bool floodAggregation = false;          // Echo over every link instead of going down the tree, to compare with
+    double aggregateValue = 0;              // Our own value in the aggregates
+    unsigned int aggregateRound = 0;        // Latest round we took part in
+    int aggregateFrom = -1;                 // Port its query came through, -1 at the root
+    std::list<int> aggregatePending;        // Ports we still expect the aggregate of that round from
+    cMessage *aggregateTimer = nullptr;     // Root: starts the next round
+    int aggregateRoundsLeft = 0;            // Root: rounds still to start on the timer
+    simtime_t aggregateInterval;            // Root: from the end of a round to the start of the next one
+    simtime_t aggregateStarted;             // Root: when the current round started
+    long aggregateRoundsDone = 0;           // Root: completed rounds
+    simtime_t aggregateLatency;             // Root: total time the completed rounds took
+    Counter<P::statistics> aggregationsSent;    // Queries, aggregates, labels and sweeps sent
+
+    bool diameter = false;                  // Root: sweep from the deepest node after the first round, see startSweep()
+    int deepestPort = -1;                   // Port towards the deepest node of our subtree in the current round, -1 if it is us
+    unsigned int sweepRound = 0;            // Latest sweep we have taken part in, by the aggregation round that started it
+    int sweepDistance = -1;                 // Our hop distance from its source, -1 if none yet
+    int sweepSource = -1;                   // Root: the node the sweep started from
+    int treeDepth = -1;                     // Root: depth of the tree in the latest round, i.e. our eccentricity
+
+    bool routing = false;                   // Label the tree after every aggregation round, see assignLabels()
+    std::vector<std::pair<int, long>> aggregateSubtrees;    // Port and subtree size of each child of the current round
+    TrafficGenerator *traffic = nullptr;    // Told about the packets delivered here
+    Counter<P::statistics> packetsForwarded;    // Data packets sent on towards their destination
+    Counter<P::statistics> packetsDropped;      // Data packets without a route, or over the hop limit
+
+    LinkTransport transport;    // Every message leaves through here, possibly bundled with others
+
+    std::vector<cGate *> linkGates;     // Per port: our output gate and the neighbour's one back to us; empty without a GUI
+    mutable int shownParent = -1;       // Port of the parent path as currently drawn, see refreshDisplay()
+    mutable bool bubblePending = false; // The parent has changed since the last refresh
+    int maxBubbles = 0;                 // Bubble limit of the network, see BubbleLimiter
+    double bubbleWindow = 0;
+
+    int numInitStages() const override { return 2; }
+    void initialize(int stage) override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+    void refreshDisplay() const override;
+
+    Message* createLayerMessage(D layer, simtime_t s = simTime());         // Creates a layerMessage with given parameters
+    ackMessage* createAckMessage(unsigned int seq);                         // Creates an ackMessage for the layerMessage `seq`
+    rejectMessage* createRejectMessage(unsigned int seq = 0);               // Creates a rejectMessage, for the ack of `seq` if not 0
+    repairMessage* createRepairMessage(short kind);                         // Creates a repairMessage of the given kind (8 to 11)
+    aggregateQueryMessage* createAggregateQuery(int depth);                 // Creates the query of the current round
+    aggregateMessage* createAggregateMessage(unsigned int round, const Aggregate& a);  // Creates an aggregateMessage carrying `a`
+    labelMessage* createLabelMessage(int start);                            // Creates the labelMessage of the current round
+    sweepMessage* createSweepMessage(int distance);                         // Creates a sweepMessage of the current sweep
+
+    void sendNow(cMessage *msg, int port);                                  // Sends msg through `port` without delay
+    void sendAfter(cMessage *msg, int port, simtime_t delay);               // Sends msg through `port` after `delay`
+    void sendLayer(int port);                                               // Sends our layer plus the link weight through `port`
+    void broadcastLayer(int except);                                        // Same through all ports but `except`
+    void sendRepair(short kind, int port);                                  // Sends a repairMessage through `port`
+    simtime_t layerDelay(int port, D layer);                                // Delay of a layerMessage carrying `layer` through `port`
+
+    void deliver(cMessage *msg, int port);                                  // Unpacks bundles received through `port` for dispatch()
+    void dispatch(cMessage *msg, int port);                                 // Passes a message received through `port` to its handler
+    bool isStale(Message *lMsg, int port);                                  // Whether a newer layerMessage came through `port` already
+    void updateMemoryAccount();                                             // Reports list entries and the FES length to the MemoryAccount
+    bool isParentOf(int port);                                              // Whether the neighbour behind `port` has us as its parent
+    std::list<int>::iterator findPort(std::list<int>& ports, int port);     // Finds `port` in the children or other list
+    void handleLayerMessage(Message *lMsg, int port);                       // Handles layerMessage(s) received
+    void handleAckMessage(ackMessage *aMsg, int port);                      // Handles ackMessage(s) received
+    void handleRejectMessage(rejectMessage *rMsg, int port);                // Handles rejectMessage(s) received
+    void handleRepairMessage(repairMessage *rMsg, int port);                // Handles withdraw, withdrawDone, rejoin and query
+    void orphan(int from);                                                  // Drops our route and withdraws our subtree
+    void finishWithdraw();                                                  // Our subtree is withdrawn: confirm upwards or rejoin
+    void rejoin();                                                          // Passes the rejoin on and asks the other neighbours for layers
+    void resetState();                                                      // Back to the state of a node that has heard nothing
+    void enterEpoch(unsigned int e);                                        // Leaves the tree of the previous epoch behind
+    void relabel(Message *lMsg, int port);                                  // Handles layers of the new epoch until our relabel
+    void finishRelabel(int port, D layer, unsigned int seq);                // Takes the layer from `port` and announces it
+    void handleAggregateQuery(aggregateQueryMessage *qMsg, int port);       // Joins a round, or answers a query we don't take
+    void handleAggregateMessage(aggregateMessage *aMsg, int port);          // Adds a child's aggregate to ours
+    void joinAggregation(unsigned int round, int from, int depth);          // Takes part in a round and passes the query on
+    void finishAggregation();                                               // All aggregates are in: pass ours up, or end the round
+    void handleLabelMessage(labelMessage *lMsg, int port);                  // Takes the label from the parent of the round
+    void assignLabels(int start);                                           // Labels our subtree from `start` on and fills the table
+    void route(dataMessage *dMsg);                                          // Delivers a data packet or forwards it one hop
+    void startSweep();                                                      // Root: sends the start of a sweep towards the deepest node
+    void handleSweepMessage(sweepMessage *sMsg, int port);                  // Passes the start on, or floods an improved distance
+
+    void printParentNode();                                                 // Prints out the node's parent node
+    void printChildrenNodes();                                              // Prints out the node's children nodes
+    void printOtherNodes();                                                 // Prints out the node's other nodes
+    void printLayer();                                                      // Prints out the node's layer
+
+    bool repairing() const { return P::options && repair; }                // The repair rules; compiled out without the options policy
+    bool dagMode() const { return P::options && dag; }                     // The DAG parents; compiled out likewise
+    bool setParent(Message *lMsg, int port);
+    void updateDagParents(Message *lMsg, int port);                         // Records whether the layer from `port` makes its sender a parent
+    void resetDagParents();                                                 // Back to our parent alone, after our layer changed some other way
+    bool failover();                                                        // Takes another parent from `dagParents`, if there is one
+    int nextDagParent();                                                    // The next of our parents in turn, for spreading packets over them
+    void setLinkStyle(int port, const char *colour, long width) const;     // Draws the link behind `port` in both directions
+    void showBubble(const char *text) const;                                // bubble(), unless there are too many on screen already
+    void hideOtherNodes();
+public:
+    virtual ~BFSNode() { cancelAndDelete(aggregateTimer); }
+    D getLayer() const { return my_layer; }
+    double getDistance() const override { return Distance<D>::toDouble(my_layer); }
+    void crash() override;
+    void restart() override;
+    void linkDown(int port) override;
+    void linkUp(int port) override;
+    void reroot() override;
+    void startAggregation() override;
+    void sendData(dataMessage *msg) override;
+    double getMaxLayer() const override { return std::isinf(Distance<D>::toDouble(maxLayer)) ? -1 : Distance<D>::toDouble(maxLayer); }
+    long getMessagesSent() const override { return layersSent + acksSent + rejectsSent + repairsSent; }
+};
+
+/*
+ * The module types of the NED file. They are classes rather than typedefs: Define_Module registers
+ * a class under its typeid name, which would be "BFSNode<int, UnitWeight, DefaultPolicy>" for a typedef.
+ */
+class Node : public BFSNode<int, UnitWeight> {};                              // Hop count, the original algorithm
+class ImmediateNode : public BFSNode<int, UnitWeight, ImmediatePolicy> {};    // Hop count, messages sent without delay
+class FastNode : public BFSNode<int, UnitWeight, FastPolicy> {};              // Hop count, no GUI, statistics or protocol variants
+class CompactNode : public BFSNode<short, UnitWeight, FastPolicy> {};         // FastNode with 16-bit layers (up to 32766 hops)
+class ProfiledNode : public BFSNode<int, UnitWeight, ProfilingPolicy> {};     // Node with its handlers instrumented
+class LatencyNode : public BFSNode<double, LinkDelayWeight> {};               // Sum of link delays, in seconds
+class CostNode : public BFSNode<FixedCost, LinkCostWeight> {};                // Sum of link costs, fixed point
+
+#endif /* ASYNC_BFS_H_ */
@@ -0,0 +1,167 @@
+/*
+ * bfs_checker.cc
+ *
+ * Checks the tree built by the nodes against centralized shortest-path distances,
+ * and times the run, for the differential test-and-benchmark configurations.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include "bfs_checker.h"
+#include "async_bfs.h"
+
+Define_Module(BFSChecker);
+
+enum { METRIC_HOPS, METRIC_DELAY, METRIC_COST };
+
+void BFSChecker::initialize() {
+    started = std::chrono::steady_clock::now();
+}
+
+void BFSChecker::handleMessage(cMessage *msg) {
+    throw cRuntimeError("BFSChecker does not process messages");
+}
+
+/*
+ * Weight of the link behind an output gate, computed the way the node type does it (see metric.h).
+ */
+double BFSChecker::weight(cGate *out, int metric) const {
+    if(metric == METRIC_HOPS)
+        return 1;
+    cChannel *channel = out->getChannel();
+    if(metric == METRIC_DELAY)
+        return channel->par("delay").doubleValue();
+    return FixedCost::fromDouble(channel->par("cost").doubleValue()).toDouble();
+}
+
+/*
+ * Dijkstra from the root (node[0] unless it was rerooted) over the output gates; with unit weights it
+ * visits nodes in BFS order. Links that are down at the end of the run (see FailureInjector) don't count,
+ * nor does a crashed root. Past the root's layer limit (its `maxLayer`, ignored by node types without the options), nodes are expected to have no layer.
+ */
+std::vector<double> BFSChecker::centralizedDistances(cModule *network, int nodeCount, int metric) const {
+    typedef std::pair<double, int> Entry;
+    std::vector<double> distance(nodeCount, INFINITY);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    int root = 0;
+    while(root < nodeCount && !check_and_cast<TreeNode *>(network->getSubmodule("node", root))->isRoot())
+        root++;
+    if(root == nodeCount || check_and_cast<TreeNode *>(network->getSubmodule("node", root))->isCrashed())
+        return distance;
+    double maxLayer = check_and_cast<TreeNode *>(network->getSubmodule("node", root))->getMaxLayer();
+    distance[root] = 0;
+    queue.push(Entry(0, root));
+    while(!queue.empty()) {
+        Entry e = queue.top();
+        queue.pop();
+        if(e.first > distance[e.second])
+            continue;
+        TreeNode *node = check_and_cast<TreeNode *>(network->getSubmodule("node", e.second));
+        for(int i = 0; i < node->gateSize("port"); i++) {
+            if(!node->isPortUp(i))
+                continue;
+            cGate *out = node->gate("port$o", i);
+            int k = out->getPathEndGate()->getOwnerModule()->getIndex();
+            double d = e.first + weight(out, metric);
+            if(maxLayer >= 0 && d > maxLayer)
+                continue;
+            if(d < distance[k]) {
+                distance[k] = d;
+                queue.push(Entry(d, k));
+            }
+        }
+    }
+    return distance;
+}
+
+static bool same(double a, double b) {
+    if(isinf(a) || isinf(b))
+        return isinf(a) && isinf(b);
+    return fabs(a - b) <= 1e-9 * std::max(1.0, fabs(b));
+}
+
+/*
+ * Ports where the node's DAG parents differ from the neighbours on a shortest path to the root.
+ * They fail the check like the other errors, see finish().
+ */
+long BFSChecker::checkDag(TreeNode *node, const std::vector<double>& expected, int metric) const {
+    long errors = 0;
+    double own = expected[node->getIndex()];
+    for(int i = 0; i < node->gateSize("port"); i++) {
+        if(!node->isPortUp(i))
+            continue;
+        cGate *out = node->gate("port$i", i)->getPathStartGate();
+        bool onPath = !isinf(own) && own > 0 && same(expected[out->getOwnerModule()->getIndex()] + weight(out, metric), own);
+        if(onPath != node->isDagParent(i) && errors++ == 0)
+            EV << node->getFullName() << ": port " << i << (onPath ? " is missing from" : " is wrongly in") << " the DAG parents" << std::endl;
+    }
+    return errors;
+}
+
+/*
+ * Ports where the node's `children` list differs from the neighbours that have it as their parent.
+ * Crashed nodes have no children, and links that are down lead to none.
+ */
+long BFSChecker::checkChildren(TreeNode *node, cModule *network) const {
+    long errors = 0;
+    const std::list<int>& children = node->getChildren();
+    for(int i = 0; i < node->gateSize("port"); i++) {
+        TreeNode *k = check_and_cast<TreeNode *>(network->getSubmodule("node", node->getNeighbour(i)));
+        bool child = !node->isCrashed() && node->isPortUp(i) && !k->isCrashed() && k->getParentNode() == node->getIndex();
+        bool listed = std::find(children.begin(), children.end(), i) != children.end();
+        if(child != listed && errors++ == 0)
+            EV << node->getFullName() << ": " << k->getFullName() << (child ? " is missing from" : " is wrongly in") << " the children" << std::endl;
+    }
+    return errors;
+}
+
+void BFSChecker::finish() {
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    recordScalar("events", (double)getSimulation()->getEventNumber());
+    recordScalar("wallTime", wallTime);
+    if(!par("enabled").boolValue())
+        return;
+
+    cModule *network = getParentModule();
+    int nodeCount = network->par("nodeCount").intValue();
+    const char *nodeType = network->par("nodeType").stringValue();
+    int metric = strcmp(nodeType, "LatencyNode") == 0 ? METRIC_DELAY : strcmp(nodeType, "CostNode") == 0 ? METRIC_COST : METRIC_HOPS;
+    std::vector<double> expected = centralizedDistances(network, nodeCount, metric);
+
+    long distanceErrors = 0, parentErrors = 0, childErrors = 0, dagErrors = 0;
+    for(int i = 0; i < nodeCount; i++) {
+        TreeNode *node = check_and_cast<TreeNode *>(network->getSubmodule("node", i));
+        if(node->hasDag())
+            dagErrors += checkDag(node, expected, metric);
+        childErrors += checkChildren(node, network);
+        if(!same(node->getDistance(), expected[i])) {
+            if(distanceErrors++ < 10)
+                EV << node->getFullName() << ": distance " << node->getDistance() << ", expected " << expected[i] << std::endl;
+        }
+        int port = node->getParent();
+        if(port == -1) {
+            if(!node->isRoot() && !isinf(expected[i]))
+                parentErrors++;
+            continue;
+        }
+        cGate *out = node->gate("port$i", port)->getPathStartGate();
+        TreeNode *parent = check_and_cast<TreeNode *>(out->getOwnerModule());
+        if(!same(parent->getDistance() + weight(out, metric), node->getDistance())) {
+            if(parentErrors++ < 10)
+                EV << node->getFullName() << ": parent " << parent->getFullName() << " is not on a shortest path" << std::endl;
+        }
+    }
+
+    recordScalar("checkedNodes", nodeCount);
+    recordScalar("distanceErrors", distanceErrors);
+    recordScalar("parentErrors", parentErrors);
+    recordScalar("childErrors", childErrors);
+    if(dagErrors)
+        recordScalar("dagErrors", dagErrors);
+    if((distanceErrors || parentErrors || childErrors || dagErrors) && par("failOnError").boolValue())
+        throw cRuntimeError("BFS tree check failed: %ld distance error(s), %ld parent error(s), %ld child error(s), %ld DAG error(s)",
+                distanceErrors, parentErrors, childErrors, dagErrors);
+}
@@ -0,0 +1,44 @@
+/*
+ * bfs_checker.h
+ *
+ * Checks the tree built by the nodes against centralized shortest-path distances,
+ * and times the run, for the differential test-and-benchmark configurations.
+ */
+
+#ifndef BFS_CHECKER_H_
+#define BFS_CHECKER_H_
+
+#include <omnetpp.h>
+#include <chrono>
+#include <vector>
+
+using namespace omnetpp;
+
+class TreeNode;
+
+/*
+ * In finish(), runs Dijkstra from node[0] over the same link weights as the node type of the
+ * network (hops, Link delays or fixed-point Link costs) and checks every node:
+ *  - its distance is the centralized one (relative tolerance 1e-9, unreached nodes infinite)
+ *  - its parent link is tight: distance(parent) + weight(parent -> node) == distance(node)
+ *  - with `dag`, its DAG parents are exactly the neighbours with a tight link (`dagErrors`, if any)
+ *  - its children are exactly the neighbours whose parent it is (`childErrors`); the aggregation
+ *    and the labelling only reach the nodes in these lists
+ * Records `checkedNodes`, `distanceErrors`, `parentErrors`, `childErrors`, `events` and `wallTime` (seconds from
+ * initialize() to finish()). With `failOnError` the run ends in an error, which Cmdenv reports
+ * and turns into a non-zero exit code. Disabled when `enabled` is false.
+ */
+class BFSChecker : public cSimpleModule {
+    std::chrono::steady_clock::time_point started;
+
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+
+    double weight(cGate *out, int metric) const;
+    std::vector<double> centralizedDistances(cModule *network, int nodeCount, int metric) const;
+    long checkDag(TreeNode *node, const std::vector<double>& expected, int metric) const;
+    long checkChildren(TreeNode *node, cModule *network) const;
+};
+
+#endif /* BFS_CHECKER_H_ */
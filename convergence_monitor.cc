@@ -0,0 +1,45 @@
+/*
+ * convergence_monitor.cc
+ *
+ * Network-wide view of the convergence: how many nodes have reached their final layer over time.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "convergence_monitor.h"
+#include "async_bfs.h"
+
+Define_Module(ConvergenceMonitor);
+
+void ConvergenceMonitor::initialize() {
+}
+
+void ConvergenceMonitor::handleMessage(cMessage *msg) {
+    throw cRuntimeError("ConvergenceMonitor does not process messages");
+}
+
+/*
+ * Like the TreeExporter, we only read the nodes' final state, so the order of the finish() calls doesn't matter.
+ */
+void ConvergenceMonitor::finish() {
+    cModule *network = getParentModule();
+    int nodeCount = network->par("nodeCount").intValue();
+
+    std::vector<simtime_t> times;
+    times.reserve(nodeCount);
+    for(int i = 0; i < nodeCount; i++) {
+        simtime_t t = check_and_cast<TreeNode *>(network->getSubmodule("node", i))->getLastChangeTime();
+        if(t >= SIMTIME_ZERO)
+            times.push_back(t);
+    }
+    std::sort(times.begin(), times.end());
+
+    cOutVector fraction("fractionConverged");
+    for(size_t i = 0; i < times.size(); i++)
+        if(i + 1 == times.size() || times[i + 1] != times[i])   // One point per distinct time, with everything that converged at it
+            fraction.recordWithTimestamp(times[i], (double)(i + 1) / nodeCount);
+
+    recordScalar("convergedNodes", (double)times.size());
+    if(!times.empty())
+        recordScalar("convergenceTime", times.back());
+}
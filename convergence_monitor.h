@@ -0,0 +1,28 @@
+/*
+ * convergence_monitor.h
+ *
+ * Network-wide view of the convergence: how many nodes have reached their final layer over time.
+ */
+
+#ifndef CONVERGENCE_MONITOR_H_
+#define CONVERGENCE_MONITOR_H_
+
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+/*
+ * Once the run is over the final layer of every node is known, and so is the time it got it.
+ * In finish() we sort those times and record
+ *  - vector `fractionConverged`: fraction of all nodes that have their final layer, stepping up at each of those times
+ *  - scalar `convergenceTime`:   time of the last layer change in the network
+ *  - scalar `convergedNodes`:    nodes that got a layer at all (the root's component)
+ * Unreached nodes never converge, so on a disconnected graph the fraction stays below 1.
+ */
+class ConvergenceMonitor : public cSimpleModule {
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+};
+
+#endif /* CONVERGENCE_MONITOR_H_ */
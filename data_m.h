@@ -0,0 +1,69 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from data.msg.
+//
+
+#ifndef __DATA_M_H
+#define __DATA_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>data.msg:1</tt> by nedtool.
+ * <pre>
+ * packet dataMessage
+ * {
+ *     int destination;
+ *     int hops;
+ *     int shortestHops;
+ * }
+ * </pre>
+ */
+class dataMessage : public ::omnetpp::cPacket
+{
+  protected:
+    int destination;
+    int hops;
+    int shortestHops;
+
+  private:
+    void copy(const dataMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const dataMessage&);
+
+  public:
+    dataMessage(const char *name=nullptr, short kind=0);
+    dataMessage(const dataMessage& other);
+    virtual ~dataMessage();
+    dataMessage& operator=(const dataMessage& other);
+    virtual dataMessage *dup() const override {return new dataMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual int getDestination() const;
+    virtual void setDestination(int destination);
+    virtual int getHops() const;
+    virtual void setHops(int hops);
+    virtual int getShortestHops() const;
+    virtual void setShortestHops(int shortestHops);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const dataMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, dataMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __DATA_M_H
+
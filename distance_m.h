@@ -0,0 +1,73 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from distance.msg.
+//
+
+#ifndef __DISTANCE_M_H
+#define __DISTANCE_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>distance.msg:1</tt> by nedtool.
+ * <pre>
+ * packet distanceMessage
+ * {
+ *     double distance;
+ *     simtime_t timeFrame;
+ *     unsigned int seq;
+ *     unsigned int epoch;
+ * }
+ * </pre>
+ */
+class distanceMessage : public ::omnetpp::cPacket
+{
+  protected:
+    double distance;
+    ::omnetpp::simtime_t timeFrame;
+    unsigned int seq;
+    unsigned int epoch;
+
+  private:
+    void copy(const distanceMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const distanceMessage&);
+
+  public:
+    distanceMessage(const char *name=nullptr, short kind=0);
+    distanceMessage(const distanceMessage& other);
+    virtual ~distanceMessage();
+    distanceMessage& operator=(const distanceMessage& other);
+    virtual distanceMessage *dup() const override {return new distanceMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual double getDistance() const;
+    virtual void setDistance(double distance);
+    virtual ::omnetpp::simtime_t getTimeFrame() const;
+    virtual void setTimeFrame(::omnetpp::simtime_t timeFrame);
+    virtual unsigned int getSeq() const;
+    virtual void setSeq(unsigned int seq);
+    virtual unsigned int getEpoch() const;
+    virtual void setEpoch(unsigned int epoch);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const distanceMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, distanceMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __DISTANCE_M_H
+
@@ -0,0 +1,180 @@
+/*
+ * failure_injector.cc
+ *
+ * Crashes and restarts nodes and takes links down and up again on a schedule,
+ * and measures what the nodes' incremental repair costs.
+ */
+
+#include <stdlib.h>
+#include <string>
+#include "failure_injector.h"
+#include "async_bfs.h"
+
+Define_Module(FailureInjector);
+
+FailureInjector::~FailureInjector() {
+    for(std::list<cMessage *>::iterator it = pending.begin(); it != pending.end(); it++)
+        cancelAndDelete(*it);
+}
+
+/*
+ * Single-stage, so this runs in stage 0, before the nodes read `repair` in stage 1.
+ */
+void FailureInjector::initialize() {
+    detectionDelay = par("detectionDelay");
+    bool atStart = par("atStart").boolValue();
+    int nodeCount = getParentModule()->par("nodeCount").intValue();
+
+    cStringTokenizer entries(par("script").stringValue(), ";");
+    while(entries.hasMoreTokens()) {
+        const char *entry = entries.nextToken();
+        std::vector<std::string> t = cStringTokenizer(entry).asVector();
+        if(t.empty())
+            continue;
+        Event e;
+        if(t.size() == 3 && t[1] == "crash")
+            e.action = CRASH;
+        else if(t.size() == 3 && t[1] == "restart")
+            e.action = RESTART;
+        else if(t.size() == 4 && t[1] == "down")
+            e.action = DOWN;
+        else if(t.size() == 4 && t[1] == "up")
+            e.action = UP;
+        else if(t.size() == 3 && t[1] == "reroot")
+            e.action = REROOT;
+        else
+            throw cRuntimeError("Bad failure event `%s'", entry);
+        e.node = atoi(t[2].c_str());
+        e.other = t.size() == 4 ? atoi(t[3].c_str()) : -1;
+        if(e.node < 0 || e.node >= nodeCount || e.other >= nodeCount)
+            throw cRuntimeError("Bad node index in failure event `%s'", entry);
+
+        cMessage *msg = new cMessage(t[1].c_str(), events.size());
+        events.push_back(e);
+        pending.push_back(msg);
+        scheduleAt(atStart ? SIMTIME_ZERO : SimTime::parse(t[0].c_str()), msg);
+    }
+    if(atStart)
+        detectionDelay = SIMTIME_ZERO;
+    if(!events.empty())
+        for(int i = 0; i < nodeCount; i++)
+            node(i)->enableRepair(par("coldReroot").boolValue());
+}
+
+/*
+ * Events at the same time are applied in the order they were scheduled, i.e. that of the script.
+ */
+void FailureInjector::handleMessage(cMessage *msg) {
+    Event e = events[msg->getKind()];
+    pending.remove(msg);
+    delete msg;
+    if(firstFailure < SIMTIME_ZERO) {
+        firstFailure = simTime();
+        messagesAtFailure = messagesSent();
+    }
+    apply(e);
+}
+
+void FailureInjector::finish() {
+    recordScalar("failureEvents", eventsApplied);
+    if(firstFailure < SIMTIME_ZERO)
+        return;
+    int nodeCount = getParentModule()->par("nodeCount").intValue();
+    simtime_t last = firstFailure;
+    for(int i = 0; i < nodeCount; i++)
+        if(node(i)->getLastChangeTime() > last)
+            last = node(i)->getLastChangeTime();
+    recordScalar("messagesAfterFailure", messagesSent() - messagesAtFailure);
+    recordScalar("repairTime", last - firstFailure);
+}
+
+TreeNode *FailureInjector::node(int i) {
+    return check_and_cast<TreeNode *>(getParentModule()->getSubmodule("node", i));
+}
+
+/*
+ * Port of node[i] whose link leads to node[j]; the first one if there are several.
+ */
+int FailureInjector::portTo(int i, int j) {
+    TreeNode *n = node(i);
+    for(int p = 0; p < n->gateSize("port"); p++)
+        if(n->gate("port$o", p)->getPathEndGate()->getOwnerModule()->getIndex() == j)
+            return p;
+    throw cRuntimeError("There is no link between node[%d] and node[%d]", i, j);
+}
+
+long FailureInjector::messagesSent() {
+    int nodeCount = getParentModule()->par("nodeCount").intValue();
+    long sent = 0;
+    for(int i = 0; i < nodeCount; i++)
+        sent += node(i)->getMessagesSent();
+    return sent;
+}
+
+void FailureInjector::apply(const Event& e) {
+    if(e.action != DETECT)
+        eventsApplied++;
+    TreeNode *n = node(e.node);
+    switch(e.action) {
+    case CRASH:
+        if(n->isCrashed())
+            break;
+        n->crash();
+        for(int p = 0; p < n->gateSize("port"); p++) {    // Every neighbour finds out on its own, after the detection delay
+            cGate *end = n->gate("port$o", p)->getPathEndGate();
+            Event d = { DETECT, end->getOwnerModule()->getIndex(), end->getIndex() };
+            cMessage *msg = new cMessage("detect", events.size());
+            events.push_back(d);
+            pending.push_back(msg);
+            scheduleAt(simTime() + detectionDelay, msg);
+        }
+        break;
+    case RESTART:
+        if(!n->isCrashed())
+            break;
+        // Neighbours that haven't noticed the crash yet do so now, before the links come back
+        for(std::list<cMessage *>::iterator it = pending.begin(); it != pending.end();) {
+            Event d = events[(*it)->getKind()];
+            if(d.action == DETECT && node(d.node)->gate("port$o", d.other)->getPathEndGate()->getOwnerModule() == n) {
+                cancelAndDelete(*it);
+                it = pending.erase(it);
+                apply(d);
+            } else {
+                it++;
+            }
+        }
+        n->restart();
+        for(int p = 0; p < n->gateSize("port"); p++) {
+            cGate *end = n->gate("port$o", p)->getPathEndGate();
+            TreeNode *k = check_and_cast<TreeNode *>(end->getOwnerModule());
+            if(k->isCrashed())
+                continue;
+            n->linkUp(p);
+            k->linkUp(end->getIndex());
+        }
+        break;
+    case DOWN: {
+        TreeNode *k = node(e.other);
+        int p = portTo(e.node, e.other), q = portTo(e.other, e.node);
+        if(!n->isCrashed() && n->isPortUp(p))
+            n->linkDown(p);
+        if(!k->isCrashed() && k->isPortUp(q))
+            k->linkDown(q);
+    } break;
+    case UP: {
+        TreeNode *k = node(e.other);
+        if(n->isCrashed() || k->isCrashed())
+            break;
+        n->linkUp(portTo(e.node, e.other));
+        k->linkUp(portTo(e.other, e.node));
+    } break;
+    case REROOT:
+        if(!n->isCrashed())
+            n->reroot();
+        break;
+    case DETECT:
+        if(!n->isCrashed() && n->isPortUp(e.other))
+            n->linkDown(e.other);
+        break;
+    }
+}
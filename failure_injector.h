@@ -0,0 +1,66 @@
+/*
+ * failure_injector.h
+ *
+ * Crashes and restarts nodes and takes links down and up again on a schedule,
+ * and measures what the nodes' incremental repair costs.
+ */
+
+#ifndef FAILURE_INJECTOR_H_
+#define FAILURE_INJECTOR_H_
+
+#include <omnetpp.h>
+#include <list>
+#include <vector>
+
+using namespace omnetpp;
+
+class TreeNode;
+
+/*
+ * `script` is a list of events separated by semicolons, each one of
+ *  - "<time> crash <i>":      node[i] stops; its neighbours notice after `detectionDelay`
+ *  - "<time> restart <i>":    node[i] comes back with an empty state, and its links come up
+ *  - "<time> down <i> <j>":   the link between node[i] and node[j] fails, both ends notice at once
+ *  - "<time> up <i> <j>":     the link works again
+ *  - "<time> reroot <i>":     node[i] becomes the root, reusing the tree (see BFSNode::reroot()),
+ *                             or flooding the network again from scratch if `coldReroot` is set
+ * e.g. "50000s crash 12; 60000s down 0 3". With a non-empty script the nodes turn their repair on
+ * (see BFSNode::orphan()); the injector does that in init stage 0, before they initialize.
+ *
+ * With `atStart` every event is applied at time 0 instead, in the order of the script, so the root
+ * builds the tree of the final topology from scratch: the full rebuild to compare the repair against.
+ *
+ * For a failover, reroot before taking the old root down: "50000s reroot 7; 60000s crash 0".
+ *
+ * Scalars, from the first event on:
+ *  - `messagesAfterFailure`: protocol messages sent by all nodes (needs nodes with statistics)
+ *  - `repairTime`:           from the first event to the last layer change in the network
+ *  - `failureEvents`:        events applied
+ */
+class FailureInjector : public cSimpleModule {
+    enum Action { CRASH, RESTART, DOWN, UP, REROOT, DETECT };
+    struct Event {
+        Action action;
+        int node;
+        int other;      // The far end of a link; for DETECT, the port of `node` that goes down
+    };
+    std::vector<Event> events;              // Indexed by the kind of the self-messages
+    std::list<cMessage *> pending;          // Scheduled self-messages, one per event
+    simtime_t detectionDelay;
+    simtime_t firstFailure = -1;
+    long messagesAtFailure = 0;
+    long eventsApplied = 0;
+
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+
+    TreeNode *node(int i);
+    int portTo(int i, int j);
+    long messagesSent();
+    void apply(const Event& e);
+public:
+    virtual ~FailureInjector();
+};
+
+#endif /* FAILURE_INJECTOR_H_ */
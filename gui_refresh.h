@@ -0,0 +1,37 @@
+/*
+ * gui_refresh.h
+ *
+ * Keeps Qtenv responsive on large networks: nodes only touch their display in
+ * refreshDisplay(), and bubbles go through a limiter shared by the whole network.
+ */
+
+#ifndef GUI_REFRESH_H_
+#define GUI_REFRESH_H_
+
+#include <chrono>
+#include <deque>
+
+/*
+ * Lets at most `maxBubbles` bubbles through in any `window` seconds of wall-clock time,
+ * which also caps how many of them are on screen at once.
+ */
+class BubbleLimiter {
+    std::deque<double> shown;   // Wall-clock times of the bubbles that may still be visible
+public:
+    static BubbleLimiter& get() {
+        static BubbleLimiter instance;
+        return instance;
+    }
+
+    bool allow(int maxBubbles, double window) {
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        while(!shown.empty() && now - shown.front() > window)
+            shown.pop_front();
+        if((int)shown.size() >= maxBubbles)
+            return false;
+        shown.push_back(now);
+        return true;
+    }
+};
+
+#endif /* GUI_REFRESH_H_ */
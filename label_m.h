@@ -0,0 +1,65 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from label.msg.
+//
+
+#ifndef __LABEL_M_H
+#define __LABEL_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>label.msg:1</tt> by nedtool.
+ * <pre>
+ * packet labelMessage
+ * {
+ *     unsigned int round;
+ *     int start;
+ * }
+ * </pre>
+ */
+class labelMessage : public ::omnetpp::cPacket
+{
+  protected:
+    unsigned int round;
+    int start;
+
+  private:
+    void copy(const labelMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const labelMessage&);
+
+  public:
+    labelMessage(const char *name=nullptr, short kind=0);
+    labelMessage(const labelMessage& other);
+    virtual ~labelMessage();
+    labelMessage& operator=(const labelMessage& other);
+    virtual labelMessage *dup() const override {return new labelMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual unsigned int getRound() const;
+    virtual void setRound(unsigned int round);
+    virtual int getStart() const;
+    virtual void setStart(int start);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const labelMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, labelMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __LABEL_M_H
+
@@ -179,13 +179,15 @@ inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
 
 Register_Class(layerMessage)
 
-layerMessage::layerMessage(const char *name, short kind) : ::omnetpp::cMessage(name,kind)
+layerMessage::layerMessage(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
 {
     this->layer = 0;
     this->timeFrame = 0;
+    this->seq = 0;
+    this->epoch = 0;
 }
 
-layerMessage::layerMessage(const layerMessage& other) : ::omnetpp::cMessage(other)
+layerMessage::layerMessage(const layerMessage& other) : ::omnetpp::cPacket(other)
 {
     copy(other);
 }
@@ -197,7 +199,7 @@ layerMessage::~layerMessage()
 layerMessage& layerMessage::operator=(const layerMessage& other)
 {
     if (this==&other) return *this;
-    ::omnetpp::cMessage::operator=(other);
+    ::omnetpp::cPacket::operator=(other);
     copy(other);
     return *this;
 }
@@ -206,20 +208,26 @@ void layerMessage::copy(const layerMessage& other)
 {
     this->layer = other.layer;
     this->timeFrame = other.timeFrame;
+    this->seq = other.seq;
+    this->epoch = other.epoch;
 }
 
 void layerMessage::parsimPack(omnetpp::cCommBuffer *b) const
 {
-    ::omnetpp::cMessage::parsimPack(b);
+    ::omnetpp::cPacket::parsimPack(b);
     doParsimPacking(b,this->layer);
     doParsimPacking(b,this->timeFrame);
+    doParsimPacking(b,this->seq);
+    doParsimPacking(b,this->epoch);
 }
 
 void layerMessage::parsimUnpack(omnetpp::cCommBuffer *b)
 {
-    ::omnetpp::cMessage::parsimUnpack(b);
+    ::omnetpp::cPacket::parsimUnpack(b);
     doParsimUnpacking(b,this->layer);
     doParsimUnpacking(b,this->timeFrame);
+    doParsimUnpacking(b,this->seq);
+    doParsimUnpacking(b,this->epoch);
 }
 
 int layerMessage::getLayer() const
@@ -242,6 +250,26 @@ void layerMessage::setTimeFrame(::omnetpp::simtime_t timeFrame)
     this->timeFrame = timeFrame;
 }
 
+unsigned int layerMessage::getSeq() const
+{
+    return this->seq;
+}
+
+void layerMessage::setSeq(unsigned int seq)
+{
+    this->seq = seq;
+}
+
+unsigned int layerMessage::getEpoch() const
+{
+    return this->epoch;
+}
+
+void layerMessage::setEpoch(unsigned int epoch)
+{
+    this->epoch = epoch;
+}
+
 class layerMessageDescriptor : public omnetpp::cClassDescriptor
 {
   private:
@@ -272,7 +300,7 @@ class layerMessageDescriptor : public omnetpp::cClassDescriptor
 
 Register_ClassDescriptor(layerMessageDescriptor)
 
-layerMessageDescriptor::layerMessageDescriptor() : omnetpp::cClassDescriptor("layerMessage", "omnetpp::cMessage")
+layerMessageDescriptor::layerMessageDescriptor() : omnetpp::cClassDescriptor("layerMessage", "omnetpp::cPacket")
 {
     propertynames = nullptr;
 }
@@ -307,7 +335,7 @@ const char *layerMessageDescriptor::getProperty(const char *propertyname) const
 int layerMessageDescriptor::getFieldCount() const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
-    return basedesc ? 2+basedesc->getFieldCount() : 2;
+    return basedesc ? 4+basedesc->getFieldCount() : 4;
 }
 
 unsigned int layerMessageDescriptor::getFieldTypeFlags(int field) const
@@ -321,8 +349,10 @@ unsigned int layerMessageDescriptor::getFieldTypeFlags(int field) const
     static unsigned int fieldTypeFlags[] = {
         FD_ISEDITABLE,
         FD_ISEDITABLE,
+        FD_ISEDITABLE,
+        FD_ISEDITABLE,
     };
-    return (field>=0 && field<2) ? fieldTypeFlags[field] : 0;
+    return (field>=0 && field<4) ? fieldTypeFlags[field] : 0;
 }
 
 const char *layerMessageDescriptor::getFieldName(int field) const
@@ -336,8 +366,10 @@ const char *layerMessageDescriptor::getFieldName(int field) const
     static const char *fieldNames[] = {
         "layer",
         "timeFrame",
+        "seq",
+        "epoch",
     };
-    return (field>=0 && field<2) ? fieldNames[field] : nullptr;
+    return (field>=0 && field<4) ? fieldNames[field] : nullptr;
 }
 
 int layerMessageDescriptor::findField(const char *fieldName) const
@@ -346,6 +378,8 @@ int layerMessageDescriptor::findField(const char *fieldName) const
     int base = basedesc ? basedesc->getFieldCount() : 0;
     if (fieldName[0]=='l' && strcmp(fieldName, "layer")==0) return base+0;
     if (fieldName[0]=='t' && strcmp(fieldName, "timeFrame")==0) return base+1;
+    if (fieldName[0]=='s' && strcmp(fieldName, "seq")==0) return base+2;
+    if (fieldName[0]=='e' && strcmp(fieldName, "epoch")==0) return base+3;
     return basedesc ? basedesc->findField(fieldName) : -1;
 }
 
@@ -360,8 +394,10 @@ const char *layerMessageDescriptor::getFieldTypeString(int field) const
     static const char *fieldTypeStrings[] = {
         "int",
         "simtime_t",
+        "unsigned int",
+        "unsigned int",
     };
-    return (field>=0 && field<2) ? fieldTypeStrings[field] : nullptr;
+    return (field>=0 && field<4) ? fieldTypeStrings[field] : nullptr;
 }
 
 const char **layerMessageDescriptor::getFieldPropertyNames(int field) const
@@ -430,6 +466,8 @@ std::string layerMessageDescriptor::getFieldValueAsString(void *object, int fiel
     switch (field) {
         case 0: return long2string(pp->getLayer());
         case 1: return simtime2string(pp->getTimeFrame());
+        case 2: return ulong2string(pp->getSeq());
+        case 3: return ulong2string(pp->getEpoch());
         default: return "";
     }
 }
@@ -446,6 +484,8 @@ bool layerMessageDescriptor::setFieldValueAsString(void *object, int field, int
     switch (field) {
         case 0: pp->setLayer(string2long(value)); return true;
         case 1: pp->setTimeFrame(string2simtime(value)); return true;
+        case 2: pp->setSeq(string2ulong(value)); return true;
+        case 3: pp->setEpoch(string2ulong(value)); return true;
         default: return false;
     }
 }
@@ -21,18 +21,22 @@
 /**
  * Class generated from <tt>layer.msg:1</tt> by nedtool.
  * <pre>
- * message layerMessage
+ * packet layerMessage
  * {
  *     int layer;
  *     simtime_t timeFrame;
+ *     unsigned int seq;
+ *     unsigned int epoch;
  * }
  * </pre>
  */
-class layerMessage : public ::omnetpp::cMessage
+class layerMessage : public ::omnetpp::cPacket
 {
   protected:
     int layer;
     ::omnetpp::simtime_t timeFrame;
+    unsigned int seq;
+    unsigned int epoch;
 
   private:
     void copy(const layerMessage& other);
@@ -55,6 +59,10 @@ class layerMessage : public ::omnetpp::cMessage
     virtual void setLayer(int layer);
     virtual ::omnetpp::simtime_t getTimeFrame() const;
     virtual void setTimeFrame(::omnetpp::simtime_t timeFrame);
+    virtual unsigned int getSeq() const;
+    virtual void setSeq(unsigned int seq);
+    virtual unsigned int getEpoch() const;
+    virtual void setEpoch(unsigned int epoch);
 };
 
 inline void doParsimPacking(omnetpp::cCommBuffer *b, const layerMessage& obj) {obj.parsimPack(b);}
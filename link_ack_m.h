@@ -0,0 +1,61 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from link_ack.msg.
+//
+
+#ifndef __LINK_ACK_M_H
+#define __LINK_ACK_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>link_ack.msg:1</tt> by nedtool.
+ * <pre>
+ * packet linkAckMessage
+ * {
+ *     unsigned int seq;
+ * }
+ * </pre>
+ */
+class linkAckMessage : public ::omnetpp::cPacket
+{
+  protected:
+    unsigned int seq;
+
+  private:
+    void copy(const linkAckMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const linkAckMessage&);
+
+  public:
+    linkAckMessage(const char *name=nullptr, short kind=0);
+    linkAckMessage(const linkAckMessage& other);
+    virtual ~linkAckMessage();
+    linkAckMessage& operator=(const linkAckMessage& other);
+    virtual linkAckMessage *dup() const override {return new linkAckMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual unsigned int getSeq() const;
+    virtual void setSeq(unsigned int seq);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const linkAckMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, linkAckMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __LINK_ACK_M_H
+
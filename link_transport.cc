@@ -0,0 +1,425 @@
+/*
+ * link_transport.cc
+ *
+ * Transport layer between a Node and its ports, packing messages that travel
+ * through the same port at the same time into a single bundleMessage, queueing
+ * them in front of datarate-limited links and retransmitting the ones a lossy link drops.
+ */
+
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include "link_transport.h"
+#include "memory_monitor.h"
+
+Register_Class(bundleMessage);
+
+void bundleMessage::copy(const bundleMessage& other) {
+    for(size_t i = 0; i < other.messages.size(); i++)
+        if(other.messages[i])
+            addMessage(other.messages[i]->dup());
+}
+
+bundleMessage::~bundleMessage() {
+    for(size_t i = 0; i < messages.size(); i++)
+        if(messages[i])
+            dropAndDelete(messages[i]);
+}
+
+bundleMessage& bundleMessage::operator=(const bundleMessage& other) {
+    if(this == &other)
+        return *this;
+    cPacket::operator=(other);
+    for(size_t i = 0; i < messages.size(); i++)
+        if(messages[i])
+            dropAndDelete(messages[i]);
+    messages.clear();
+    copy(other);
+    return *this;
+}
+
+void bundleMessage::addMessage(cMessage *msg) {
+    take(msg);
+    messages.push_back(msg);
+    if(msg->isPacket())
+        addBitLength(static_cast<cPacket *>(msg)->getBitLength());
+}
+
+cMessage *bundleMessage::removeMessage(int i) {
+    cMessage *msg = messages[i];
+    messages[i] = nullptr;
+    drop(msg);
+    return msg;
+}
+
+LinkTransport::~LinkTransport() {
+    if(flushTimer)
+        module->cancelAndDelete(flushTimer);
+    for(size_t p = 0; p < pending.size(); p++)
+        for(size_t b = 0; b < pending[p].size(); b++)
+            for(size_t i = 0; i < pending[p][b].messages.size(); i++)
+                delete pending[p][b].messages[i];
+    for(size_t p = 0; p < txQueues.size(); p++) {
+        if(txQueues[p].timer)
+            module->cancelAndDelete(txQueues[p].timer);
+        for(size_t i = 0; i < txQueues[p].heap.size(); i++)
+            delete txQueues[p].heap[i].msg;
+    }
+    if(wheelTimer)
+        module->cancelAndDelete(wheelTimer);
+    for(size_t p = 0; p < unacked.size(); p++)
+        for(auto it = unacked[p].begin(); it != unacked[p].end(); ++it)
+            delete it->second.copy;
+}
+
+void LinkTransport::init(cSimpleModule *module, int ports, Mode mode) {
+    this->module = module;
+    this->mode = mode;
+    pending.resize(ports);
+    if(mode == INSTANT) {
+        flushTimer = new cMessage("flushTimer");
+        flushTimer->setSchedulingPriority(SHRT_MAX);    // Run after everything else due at the same time
+    }
+
+    for(int i = 0; i < ports; i++) {
+        cChannel *channel = module->gate("port$o", i)->findTransmissionChannel();
+        if(!channel || channel->getNominalDatarate() <= 0)
+            continue;
+        if(txQueues.empty())
+            txQueues.resize(ports);
+        txQueues[i].port = i;
+        txQueues[i].channel = channel;
+        txQueues[i].timer = new cMessage("txTimer", 5);
+        txQueues[i].timer->setContextPointer(&txQueues[i]);
+    }
+}
+
+/*
+ * Turns on the reliability layer, see the class comment.
+ */
+void LinkTransport::initReliability(simtime_t retransmitTimeout, int maxRetransmissions, simtime_t resolution) {
+    int ports = pending.size();
+    reliable = true;
+    this->retransmitTimeout = retransmitTimeout;
+    this->maxRetransmissions = maxRetransmissions;
+    nextSeq.assign(ports, 0);
+    unacked.resize(ports);
+    received.resize(ports);
+    wheel.init(resolution, 256);
+    wheelTimer = new cMessage("retransmitTimer");
+}
+
+LinkTransport::Mode LinkTransport::parseMode(const char *s) {
+    if(strcmp(s, "none") == 0)
+        return NONE;
+    if(strcmp(s, "event") == 0)
+        return EVENT;
+    if(strcmp(s, "instant") == 0)
+        return INSTANT;
+    throw cRuntimeError("Unknown bundling mode `%s'", s);
+}
+
+void LinkTransport::sendNow(cMessage *msg, int port, simtime_t delay) {
+    if(msg->isPacket())
+        bitsSent += static_cast<cPacket *>(msg)->getBitLength();
+    if(delay == SIMTIME_ZERO)
+        module->send(msg, "port$o", port);
+    else
+        module->sendDelayed(msg, delay, "port$o", port);
+}
+
+/*
+ * Sends msg through `port` after `delay`, or queues it until the next flush.
+ */
+void LinkTransport::send(cMessage *msg, int port, simtime_t delay) {
+    if(mode == NONE) {
+        transmit(msg, port, delay);
+        return;
+    }
+
+    std::vector<Batch>& batches = pending[port];
+    if(batches.empty())
+        dirtyPorts.push_back(port);
+    size_t b = 0;
+    while(b < batches.size() && batches[b].delay != delay)
+        b++;
+    if(b == batches.size()) {
+        batches.push_back(Batch());
+        batches[b].delay = delay;
+    }
+    batches[b].messages.push_back(msg);
+
+    if(mode == INSTANT && !flushTimer->isScheduled())
+        module->scheduleAt(simTime(), flushTimer);
+}
+
+void LinkTransport::endOfEvent() {
+    if(mode == EVENT)
+        flush();
+}
+
+/*
+ * Sends out every batch; a batch of one goes as it is, bigger ones inside a bundleMessage.
+ */
+void LinkTransport::flush() {
+    for(size_t d = 0; d < dirtyPorts.size(); d++) {
+        int port = dirtyPorts[d];
+        std::vector<Batch>& batches = pending[port];
+        for(size_t b = 0; b < batches.size(); b++) {
+            std::vector<cMessage *>& messages = batches[b].messages;
+            if(messages.size() == 1) {
+                transmit(messages[0], port, batches[b].delay);
+                continue;
+            }
+            bundleMessage *bundle = new bundleMessage;
+            bundle->setBitLength(KIND_BITS + varintBits(messages.size()));
+            short priority = SHRT_MAX;
+            for(size_t i = 0; i < messages.size(); i++) {
+                bundle->addMessage(messages[i]);
+                priority = std::min(priority, messages[i]->getSchedulingPriority());
+            }
+            bundle->setSchedulingPriority(priority);  // That of the most urgent message inside, see BFSNode::createLayerMessage()
+            if(accountMemory)
+                MemoryAccount::get().add(MEM_BUNDLE, 1, sizeof(bundleMessage) + messages.size() * sizeof(cMessage *));
+            transmit(bundle, port, batches[b].delay);
+            bundlesSent++;
+            messagesBundled += messages.size();
+        }
+        batches.clear();
+    }
+    dirtyPorts.clear();
+}
+
+/*
+ * Sends msg through `port` after `delay`, through the port's transmit queue if it has one.
+ * A message that is due now on an idle link with nothing ready before it skips the queue.
+ */
+void LinkTransport::transmit(cMessage *msg, int port, simtime_t delay) {
+    if(reliable && msg->getKind() != 6 && msg->getKind() != 7) {   // Neither a wrapper already nor a link ack
+        uint32_t seq = nextSeq[port]++;
+        Unacked u = { check_and_cast<cPacket *>(msg)->dup(), delay, 0 };
+        account(u.copy, 1);
+        unacked[port][seq] = u;
+        armTimer(port, seq, u);
+        sendReliable(check_and_cast<cPacket *>(msg), port, delay, seq);
+        return;
+    }
+    if(txQueues.empty() || !txQueues[port].channel) {
+        sendNow(msg, port, delay);
+        return;
+    }
+    TxQueue& q = txQueues[port];
+    simtime_t now = simTime();
+    if(delay == SIMTIME_ZERO && q.channel->getTransmissionFinishTime() <= now && (q.heap.empty() || q.heap.front().ready > now)) {
+        sendNow(msg, port, SIMTIME_ZERO);
+        return;
+    }
+    q.heap.push_back(TxItem{now + delay, txSeq++, msg});
+    std::push_heap(q.heap.begin(), q.heap.end());
+    wakeUp(q);
+}
+
+/*
+ * (Re)schedules the queue's timer for when its first message is ready and the link is idle.
+ */
+void LinkTransport::wakeUp(TxQueue& q) {
+    simtime_t next = std::max(q.heap.front().ready, std::max(q.channel->getTransmissionFinishTime(), simTime()));
+    if(q.timer->isScheduled()) {
+        if(q.timer->getArrivalTime() <= next)
+            return;
+        module->cancelEvent(q.timer);
+    }
+    module->scheduleAt(next, q.timer);
+}
+
+/*
+ * Puts the first ready message on the link, unless a message that skipped the queue is still being transmitted.
+ */
+void LinkTransport::handleTxTimer(TxQueue& q) {
+    simtime_t now = simTime();
+    if(q.channel->getTransmissionFinishTime() <= now) {
+        std::pop_heap(q.heap.begin(), q.heap.end());
+        TxItem item = q.heap.back();
+        q.heap.pop_back();
+        if(item.ready < now) {
+            txQueued++;
+            txQueueingDelay += now - item.ready;
+        }
+        sendNow(item.msg, q.port, SIMTIME_ZERO);
+    }
+    if(!q.heap.empty())
+        wakeUp(q);
+}
+
+void LinkTransport::handleTimer(cMessage *msg) {
+    if(msg == flushTimer)
+        flush();
+    else if(msg == wheelTimer)
+        handleWheelTimer();
+    else
+        handleTxTimer(*static_cast<TxQueue *>(msg->getContextPointer()));
+}
+
+/*
+ * Forgets everything on its way out through `port`: batches not flushed yet, the transmit queue and the
+ * copies kept for retransmission. Sequence numbers start over, as they do at the other end, which resets
+ * the port as well. With port -1 (a crash) that goes for every port, and the flush and retransmission
+ * timers are cancelled.
+ */
+void LinkTransport::reset(int port) {
+    if(port == -1) {
+        for(int p = 0; p < (int)pending.size(); p++)
+            reset(p);
+        if(flushTimer)
+            module->cancelEvent(flushTimer);
+        if(wheelTimer) {
+            module->cancelEvent(wheelTimer);
+            wheel.clear();
+        }
+        return;
+    }
+    for(size_t b = 0; b < pending[port].size(); b++)
+        for(size_t i = 0; i < pending[port][b].messages.size(); i++) {
+            account(pending[port][b].messages[i], -1);
+            delete pending[port][b].messages[i];
+        }
+    pending[port].clear();
+    dirtyPorts.erase(std::remove(dirtyPorts.begin(), dirtyPorts.end(), port), dirtyPorts.end());
+    if(!txQueues.empty() && txQueues[port].channel) {
+        TxQueue& q = txQueues[port];
+        module->cancelEvent(q.timer);
+        for(size_t i = 0; i < q.heap.size(); i++) {
+            account(q.heap[i].msg, -1);
+            delete q.heap[i].msg;
+        }
+        q.heap.clear();
+    }
+    if(reliable) {
+        for(auto it = unacked[port].begin(); it != unacked[port].end(); ++it) {
+            account(it->second.copy, -1);
+            delete it->second.copy;
+        }
+        unacked[port].clear();
+        wheel.remove(port);
+        nextSeq[port] = 0;
+        received[port] = Received();
+    }
+}
+
+/*
+ * Wraps msg with its sequence number and hands it to the transmit queue or the link.
+ */
+void LinkTransport::sendReliable(cPacket *msg, int port, simtime_t delay, uint32_t seq) {
+    reliableMessage *wrapper = new reliableMessage("reliable", 6);
+    wrapper->setSeq(seq);
+    wrapper->setBitLength(KIND_BITS + varintBits(seq));
+    wrapper->encapsulate(msg);
+    wrapper->setSchedulingPriority(msg->getSchedulingPriority());
+    if(txQueues.empty() || !txQueues[port].channel)
+        sendNow(wrapper, port, delay);
+    else
+        transmit(wrapper, port, delay);
+}
+
+/*
+ * The timer fires `retransmitTimeout` after the copy is due at the other end, doubled for every retry.
+ */
+void LinkTransport::armTimer(int port, uint32_t seq, const Unacked& u) {
+    wheel.add(simTime() + u.delay + retransmitTimeout * (double)(1 << std::min(u.retries, 20)), port, seq);
+    simtime_t next = wheel.nextDeadline();
+    if(wheelTimer->isScheduled()) {
+        if(wheelTimer->getArrivalTime() <= next)
+            return;
+        module->cancelEvent(wheelTimer);
+    }
+    module->scheduleAt(std::max(next, simTime()), wheelTimer);
+}
+
+/*
+ * Sends again whatever is still unacked among the timers that are due; timers of acked messages are just dropped.
+ */
+void LinkTransport::handleWheelTimer() {
+    std::vector<TimerWheel::Timer> due;
+    wheel.expire(simTime(), due);
+    for(size_t i = 0; i < due.size(); i++) {
+        auto it = unacked[due[i].port].find(due[i].seq);
+        if(it == unacked[due[i].port].end())
+            continue;
+        Unacked& u = it->second;
+        if(u.retries >= maxRetransmissions) {
+            retransmitsAbandoned++;
+            account(u.copy, -1);
+            delete u.copy;
+            unacked[due[i].port].erase(it);
+            continue;
+        }
+        u.retries++;
+        retransmissions++;
+        cPacket *copy = u.copy->dup();
+        account(copy, 1);
+        sendReliable(copy, due[i].port, u.delay, due[i].seq);
+        armTimer(due[i].port, due[i].seq, u);
+    }
+    if(!wheel.empty() && !wheelTimer->isScheduled())
+        module->scheduleAt(std::max(wheel.nextDeadline(), simTime()), wheelTimer);
+}
+
+/*
+ * Drops lost messages, consumes link acks, acks and unwraps reliable messages and drops duplicates.
+ */
+cMessage *LinkTransport::receive(cMessage *msg, int port) {
+    if(msg->isPacket() && static_cast<cPacket *>(msg)->hasBitError()) {
+        messagesLost++;
+        account(msg, -1);
+        delete msg;
+        return nullptr;
+    }
+    if(msg->getKind() == 7) {
+        uint32_t seq = check_and_cast<linkAckMessage *>(msg)->getSeq();
+        delete msg;
+        if(!reliable)
+            return nullptr;
+        auto it = unacked[port].find(seq);
+        if(it != unacked[port].end()) {
+            account(it->second.copy, -1);
+            delete it->second.copy;
+            unacked[port].erase(it);
+        }
+        return nullptr;
+    }
+    if(msg->getKind() != 6)
+        return msg;
+
+    reliableMessage *wrapper = check_and_cast<reliableMessage *>(msg);
+    uint32_t seq = wrapper->getSeq();
+    linkAckMessage *ack = new linkAckMessage("linkAck", 7);
+    ack->setSeq(seq);
+    ack->setBitLength(KIND_BITS + varintBits(seq));
+    transmit(ack, port, SIMTIME_ZERO);
+    linkAcksSent++;
+
+    Received& r = received[port];
+    if(seq < r.below || r.above.count(seq)) {
+        duplicatesDropped++;
+        account(wrapper, -1);
+        delete wrapper;
+        return nullptr;
+    }
+    if(seq == r.below) {
+        r.below++;
+        while(!r.above.empty() && *r.above.begin() == r.below) {
+            r.above.erase(r.above.begin());
+            r.below++;
+        }
+    } else {
+        r.above.insert(seq);
+    }
+    cPacket *payload = wrapper->decapsulate();
+    delete wrapper;
+    return payload;
+}
+
+void LinkTransport::account(const cMessage *msg, int sign) {
+    if(accountMemory)
+        MemoryAccount::get().addMessage(msg, sign);
+}
@@ -0,0 +1,146 @@
+/*
+ * link_transport.h
+ *
+ * Transport layer between a Node and its ports, packing messages that travel
+ * through the same port at the same time into a single bundleMessage, queueing
+ * them in front of datarate-limited links and retransmitting the ones a lossy link drops.
+ */
+
+#ifndef LINK_TRANSPORT_H_
+#define LINK_TRANSPORT_H_
+
+#include <omnetpp.h>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "wire_size.h"
+#include "timer_wheel.h"
+#include "reliable_m.h"
+#include "link_ack_m.h"
+
+using namespace omnetpp;
+
+/*
+ * Carries several protocol messages through one port as a single event.
+ * Its `kind` is 4, next to layerMessage (1), ackMessage (2) and rejectMessage (3).
+ * Its bit length is that of its messages plus a type tag and a message count.
+ */
+class bundleMessage : public cPacket {
+    std::vector<cMessage *> messages;
+    void copy(const bundleMessage& other);
+public:
+    bundleMessage(const char *name = "bundle", short kind = 4) : cPacket(name, kind) {}
+    bundleMessage(const bundleMessage& other) : cPacket(other) { copy(other); }
+    virtual ~bundleMessage();
+    bundleMessage& operator=(const bundleMessage& other);
+    virtual bundleMessage *dup() const override { return new bundleMessage(*this); }
+
+    void addMessage(cMessage *msg);                 // Takes ownership of msg
+    int getMessageCount() const { return messages.size(); }
+    cMessage *removeMessage(int i);                 // Gives up ownership of the i-th message, the caller has to take() it
+    const cMessage *getMessage(int i) const { return messages[i]; }
+};
+
+/*
+ * Outgoing messages are queued per port and grouped by their delay, so that a bundle never
+ * arrives at a different time than its messages would have on their own. The queue is flushed
+ *  - EVENT:   at the end of the event that produced the messages (endOfEvent()). A handler sends at most
+ *             one message per port, so this only bundles the answers to a bundle that came in,
+ *  - INSTANT: once every event of the current simulated instant has run; a self-message with a
+ *             lower scheduling priority than everything else takes care of that.
+ * With NONE every message is sent right away, exactly as without the transport.
+ *
+ * Ports whose link is a datarate channel (datarate > 0) get a transmit queue: a message is
+ * ready once its delay has passed and leaves as soon as the link is idle, in order of readiness.
+ * A self-message of kind 5 per port wakes the queue up. Other ports are sent to directly.
+ *
+ * Messages with a bit error (the `per` of a Link) are dropped on arrival. With `reliable` set, every
+ * message is wrapped in a reliableMessage (kind 6) with a per-port sequence number and a copy is kept
+ * until a linkAckMessage (kind 7) for it comes back. Retransmission timers of all ports live in one
+ * TimerWheel behind a single self-message; a timer fires `retransmitTimeout` after the message was
+ * due to arrive, doubling with every retry, and the message is given up after `maxRetransmissions`.
+ * The receiver acks every copy it gets and delivers each sequence number once.
+ */
+class LinkTransport {
+public:
+    enum Mode { NONE, EVENT, INSTANT };
+private:
+    struct Batch {
+        simtime_t delay;
+        std::vector<cMessage *> messages;
+    };
+    cSimpleModule *module = nullptr;
+    Mode mode = NONE;
+    cMessage *flushTimer = nullptr;
+    std::vector<std::vector<Batch>> pending;        // Batches waiting to be sent, per port
+    std::vector<int> dirtyPorts;                    // Ports that have something in `pending`
+
+    struct TxItem {
+        simtime_t ready;                            // When the message may start transmitting
+        long seq;                                   // Keeps messages ready at the same time in FIFO order
+        cMessage *msg;
+        bool operator<(const TxItem& o) const { return ready > o.ready || (ready == o.ready && seq > o.seq); }
+    };
+    struct TxQueue {
+        int port = -1;
+        cChannel *channel = nullptr;                // Datarate channel behind the port, nullptr if the port has none
+        cMessage *timer = nullptr;
+        std::vector<TxItem> heap;                   // Min-heap on (ready, seq)
+    };
+    std::vector<TxQueue> txQueues;                  // Per port, empty if no port has a datarate channel
+    long txSeq = 0;
+
+    struct Unacked {
+        cPacket *copy;                              // What to send again
+        simtime_t delay;                            // The delay it was sent with
+        int retries;
+    };
+    struct Received {
+        uint32_t below = 0;                         // Every sequence number below this has been delivered
+        std::set<uint32_t> above;                   // and these above it
+    };
+    bool reliable = false;
+    simtime_t retransmitTimeout;
+    int maxRetransmissions = 0;
+    std::vector<uint32_t> nextSeq;                  // Per port
+    std::vector<std::unordered_map<uint32_t, Unacked>> unacked;
+    std::vector<Received> received;
+    TimerWheel wheel;
+    cMessage *wheelTimer = nullptr;
+
+    void sendNow(cMessage *msg, int port, simtime_t delay);
+    void transmit(cMessage *msg, int port, simtime_t delay);
+    void wakeUp(TxQueue& q);
+    void handleTxTimer(TxQueue& q);
+    void flush();
+    void sendReliable(cPacket *msg, int port, simtime_t delay, uint32_t seq);
+    void armTimer(int port, uint32_t seq, const Unacked& u);
+    void handleWheelTimer();
+    void account(const cMessage *msg, int sign);
+public:
+    long bundlesSent = 0;                           // Bundles sent, each of them one event instead of getMessageCount()
+    long messagesBundled = 0;                       // Messages that travelled inside a bundle
+    int64_t bitsSent = 0;                           // Bit length of everything put on the links
+    long txQueued = 0;                              // Messages that had to wait for a busy link
+    simtime_t txQueueingDelay = 0;                  // Total time they waited
+    long messagesLost = 0;                          // Messages that arrived with a bit error and were dropped
+    long retransmissions = 0;
+    long retransmitsAbandoned = 0;                  // Messages given up after maxRetransmissions
+    long linkAcksSent = 0;
+    long duplicatesDropped = 0;                     // Copies of messages delivered already
+    bool accountMemory = false;                     // Report bundles and copies to the MemoryAccount
+
+    ~LinkTransport();
+    void init(cSimpleModule *module, int ports, Mode mode);
+    void initReliability(simtime_t retransmitTimeout, int maxRetransmissions, simtime_t resolution);
+    static Mode parseMode(const char *s);
+
+    void send(cMessage *msg, int port, simtime_t delay);
+    cMessage *receive(cMessage *msg, int port);     // What to hand to the node, nullptr if the transport kept or dropped msg
+    void endOfEvent();                              // To be called at the end of every handleMessage()
+    bool isTimer(cMessage *msg) const { return msg == flushTimer || msg == wheelTimer || (!txQueues.empty() && msg->isSelfMessage() && msg->getKind() == 5); }
+    void handleTimer(cMessage *msg);
+    void reset(int port);                           // Drops what is queued or unacked for `port`, or for every port if -1
+};
+
+#endif /* LINK_TRANSPORT_H_ */
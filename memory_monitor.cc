@@ -0,0 +1,81 @@
+/*
+ * memory_monitor.cc
+ *
+ * Live and peak memory of the simulation, per category, to size the largest network a machine can run.
+ */
+
+#include <string>
+#include "memory_monitor.h"
+#include "link_transport.h"
+
+Define_Module(MemoryMonitor);
+
+void MemoryAccount::reset() {
+    for(int i = 0; i < MEM_CATEGORIES; i++) {
+        count[i] = peakCount[i] = 0;
+        bytes[i] = peakBytes[i] = 0;
+    }
+    for(int i = 0; i < 1 << KIND_BITS; i++)
+        messageBytes[i] = 0;
+    total = peakTotal = 0;
+}
+
+void MemoryAccount::addMessage(const cMessage *msg, int sign) {
+    switch(msg->getKind()) {
+    case 1: add(MEM_LAYER, sign, sign * messageBytes[1]); break;
+    case 2: add(MEM_ACK, sign, sign * messageBytes[2]); break;
+    case 3: add(MEM_REJECT, sign, sign * messageBytes[3]); break;
+    case 8: case 9: case 10: case 11: add(MEM_REPAIR, sign, sign * messageBytes[msg->getKind()]); break;
+    case 12: case 13: case 14: case 16: add(MEM_AGGREGATE, sign, sign * messageBytes[msg->getKind()]); break;
+    case 4: {
+        const bundleMessage *bundle = static_cast<const bundleMessage *>(msg);
+        add(MEM_BUNDLE, sign, sign * (int64_t)(sizeof(bundleMessage) + bundle->getMessageCount() * sizeof(cMessage *)));
+        for(int i = 0; i < bundle->getMessageCount(); i++)
+            if(bundle->getMessage(i))
+                addMessage(bundle->getMessage(i), sign);
+    } break;
+    case 6:
+        addMessage(static_cast<const cPacket *>(msg)->getEncapsulatedPacket(), sign);
+        break;
+    }
+}
+
+void MemoryAccount::add(MemoryCategory c, long n, int64_t b) {
+    count[c] += n;
+    bytes[c] += b;
+    total += b;
+    if(count[c] > peakCount[c])
+        peakCount[c] = count[c];
+    if(bytes[c] > peakBytes[c])
+        peakBytes[c] = bytes[c];
+    if(total > peakTotal)
+        peakTotal = total;
+}
+
+void MemoryAccount::record(cComponent *component) const {
+    static const char *names[MEM_CATEGORIES] = {
+        "nodeState", "listEntries", "layerMessages", "ackMessages", "rejectMessages", "repairMessages", "aggregationMessages", "bundles", "fes"
+    };
+    for(int i = 0; i < MEM_CATEGORIES; i++) {
+        component->recordScalar((std::string(names[i]) + "Count").c_str(), count[i]);
+        component->recordScalar((std::string(names[i]) + "PeakCount").c_str(), peakCount[i]);
+        component->recordScalar((std::string(names[i]) + "Bytes").c_str(), (double)bytes[i]);
+        component->recordScalar((std::string(names[i]) + "PeakBytes").c_str(), (double)peakBytes[i]);
+    }
+    component->recordScalar("peakTotalBytes", (double)peakTotal);
+}
+
+/*
+ * Single-stage, so this runs in stage 0, before the nodes account for themselves in stage 1.
+ */
+void MemoryMonitor::initialize() {
+    MemoryAccount::get().reset();
+}
+
+void MemoryMonitor::handleMessage(cMessage *msg) {
+    throw cRuntimeError("MemoryMonitor does not process messages");
+}
+
+void MemoryMonitor::finish() {
+    MemoryAccount::get().record(this);
+}
@@ -0,0 +1,69 @@
+/*
+ * memory_monitor.h
+ *
+ * Live and peak memory of the simulation, per category, to size the largest network a machine can run.
+ */
+
+#ifndef MEMORY_MONITOR_H_
+#define MEMORY_MONITOR_H_
+
+#include <omnetpp.h>
+#include <stdint.h>
+#include "wire_size.h"
+
+using namespace omnetpp;
+
+enum MemoryCategory {
+    MEM_NODE_STATE,     // Node objects, their per-port vectors and their gates
+    MEM_LIST_ENTRIES,   // Entries of the children/other lists
+    MEM_LAYER,          // In-flight messages, by type
+    MEM_ACK,
+    MEM_REJECT,
+    MEM_REPAIR,
+    MEM_AGGREGATE,      // Aggregation queries, aggregates, labels and sweeps
+    MEM_BUNDLE,         // Bundle objects themselves; their contents count under their own type
+    MEM_FES,            // Event heap slots (one pointer per scheduled event)
+    MEM_CATEGORIES
+};
+
+/*
+ * Counts and bytes of every category, plus their peaks and the peak of the total.
+ * Bytes are sizeof() of the objects involved, so allocator overhead isn't included.
+ * Reliability wrappers and link acks aren't counted, the messages inside the wrappers are.
+ * One account for the whole network, reset by the MemoryMonitor at the start of every run.
+ */
+class MemoryAccount {
+    long count[MEM_CATEGORIES];
+    long peakCount[MEM_CATEGORIES];
+    int64_t bytes[MEM_CATEGORIES];
+    int64_t peakBytes[MEM_CATEGORIES];
+    int64_t total;
+    int64_t peakTotal;
+    int64_t messageBytes[1 << KIND_BITS];   // Size of the message class of each kind, registered by the nodes
+public:
+    static MemoryAccount& get() {
+        static MemoryAccount instance;
+        return instance;
+    }
+    MemoryAccount() { reset(); }
+    void reset();
+    void add(MemoryCategory c, long n, int64_t b);
+    void remove(MemoryCategory c, long n, int64_t b) { add(c, -n, -b); }
+    void set(MemoryCategory c, long n, int64_t b) { add(c, n - count[c], b - bytes[c]); }
+    void setMessageBytes(short kind, int64_t b) { messageBytes[kind] = b; }
+    void addMessage(const cMessage *msg, int sign);     // Adds (sign 1) or removes (-1) msg by its kind, contents included
+    void record(cComponent *component) const;
+};
+
+/*
+ * Resets the account in initialize() and records, for every category,
+ * `<category>Count`, `<category>PeakCount`, `<category>Bytes` and `<category>PeakBytes`,
+ * then `peakTotalBytes`, in finish(). Nodes without statistics don't report to the account.
+ */
+class MemoryMonitor : public cSimpleModule {
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+};
+
+#endif /* MEMORY_MONITOR_H_ */
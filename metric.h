@@ -0,0 +1,143 @@
+/*
+ * metric.h
+ *
+ * Distance types and edge weight sources the BFS node can be instantiated with.
+ * Hop count (int + UnitWeight) is the original algorithm; the others build
+ * shortest-path trees over link parameters set in NED.
+ */
+
+#ifndef METRIC_H_
+#define METRIC_H_
+
+#include <omnetpp.h>
+#include <math.h>
+#include <limits.h>
+#include <float.h>
+#include <ostream>
+#include <vector>
+#include "layer_m.h"
+#include "distance_m.h"
+#include "wire_size.h"
+
+using namespace omnetpp;
+
+/*
+ * Fixed-point cost with three decimals, kept in an int so that it travels in a layerMessage.
+ */
+struct FixedCost {
+    static const int SCALE = 1000;
+    int raw;
+
+    FixedCost(int raw = 0) : raw(raw) {}
+    static FixedCost fromDouble(double d) { return FixedCost((int)lround(d * SCALE)); }
+    double toDouble() const { return (double)raw / SCALE; }
+
+    FixedCost operator+(const FixedCost& o) const { return FixedCost(raw + o.raw); }
+    bool operator<(const FixedCost& o) const { return raw < o.raw; }
+    bool operator>=(const FixedCost& o) const { return raw >= o.raw; }
+    bool operator==(const FixedCost& o) const { return raw == o.raw; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const FixedCost& c) {
+    return os << c.toDouble();
+}
+
+/*
+ * What a distance type needs: the message carrying it, its zero/unit/infinity values,
+ * its encoded size in bits and the conversions used for reporting.
+ */
+template<typename D> struct Distance;
+
+template<> struct Distance<int> {
+    typedef layerMessage message_type;
+    static int zero() { return 0; }
+    static int one() { return 1; }
+    static int infinity() { return INT_MAX; }
+    static int get(const layerMessage *m) { return m->getLayer(); }
+    static void set(layerMessage *m, int d) { m->setLayer(d); }
+    static int fromDouble(double d) { return (int)d; }
+    static int bits(int d) { return varintBits(d); }
+    static double toDouble(int d) { return d == INT_MAX ? INFINITY : d; }
+};
+
+template<> struct Distance<short> {
+    typedef layerMessage message_type;
+    static short zero() { return 0; }
+    static short one() { return 1; }
+    static short infinity() { return SHRT_MAX; }
+    static short get(const layerMessage *m) { return (short)m->getLayer(); }
+    static void set(layerMessage *m, short d) { m->setLayer(d); }
+    static short fromDouble(double d) { return (short)d; }
+    static int bits(short d) { return varintBits(d); }
+    static double toDouble(short d) { return d == SHRT_MAX ? INFINITY : d; }
+};
+
+template<> struct Distance<double> {
+    typedef distanceMessage message_type;
+    static double zero() { return 0; }
+    static double one() { return 1; }
+    static double infinity() { return INFINITY; }
+    static double get(const distanceMessage *m) { return m->getDistance(); }
+    static void set(distanceMessage *m, double d) { m->setDistance(d); }
+    static double fromDouble(double d) { return d; }
+    static int bits(double d) { return 64; }
+    static double toDouble(double d) { return d; }
+};
+
+template<> struct Distance<FixedCost> {
+    typedef layerMessage message_type;
+    static FixedCost zero() { return FixedCost(0); }
+    static FixedCost one() { return FixedCost(FixedCost::SCALE); }
+    static FixedCost infinity() { return FixedCost(INT_MAX); }
+    static FixedCost get(const layerMessage *m) { return FixedCost(m->getLayer()); }
+    static void set(layerMessage *m, FixedCost d) { m->setLayer(d.raw); }
+    static FixedCost fromDouble(double d) { return FixedCost::fromDouble(d); }
+    static int bits(FixedCost d) { return varintBits(d.raw); }
+    static double toDouble(FixedCost d) { return d.raw == INT_MAX ? INFINITY : d.toDouble(); }
+};
+
+/*
+ * Every link counts as one; nothing to look up, so the hop count build stays as it was.
+ */
+template<typename D> struct UnitWeight {
+    static const char *parameter() { return nullptr; }      // Channel parameter the weights come from, none here
+    void init(cModule *node) {}
+    D weight(int port) const { return Distance<D>::one(); }
+};
+
+/*
+ * Weight taken from a parameter of the channel on each outgoing port, read once in init().
+ */
+template<typename D> class LinkParWeight {
+    std::vector<D> weights;
+protected:
+    void init(cModule *node, const char *parName) {
+        weights.resize(node->gateSize("port"));
+        for(int i = 0; i < node->gateSize("port"); i++) {
+            cChannel *channel = node->gate("port$o", i)->getChannel();
+            if(!channel || !channel->hasPar(parName))
+                throw cRuntimeError("%s: link on port %d has no `%s' parameter (set weightedLinks = true)", node->getFullPath().c_str(), i, parName);
+            weights[i] = Distance<D>::fromDouble(channel->par(parName).doubleValue());
+        }
+    }
+public:
+    D weight(int port) const { return weights[port]; }
+};
+
+/*
+ * Link latency: the `delay` of the channel, in seconds.
+ */
+template<typename D> struct LinkDelayWeight : LinkParWeight<D> {
+    static const char *parameter() { return "delay"; }
+    void init(cModule *node) { LinkParWeight<D>::init(node, parameter()); }
+};
+
+/*
+ * Link cost: the `cost` parameter of the Link channel, e.g. an inverse bandwidth.
+ */
+template<typename D> struct LinkCostWeight : LinkParWeight<D> {
+    static const char *parameter() { return "cost"; }
+    void init(cModule *node) { LinkParWeight<D>::init(node, parameter()); }
+};
+
+#endif /* METRIC_H_ */
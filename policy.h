@@ -0,0 +1,67 @@
+/*
+ * policy.h
+ *
+ * Compile-time policies of the BFS node. Every feature a policy turns off is a constant
+ * false condition in the node, so the compiler removes it from the handlers altogether.
+ */
+
+#ifndef POLICY_H_
+#define POLICY_H_
+
+/*
+ * Statistics counter; with statistics turned off it has no state and increments do nothing.
+ */
+template<bool enabled> struct Counter {
+    long n = 0;
+    void operator++(int) { n++; }
+    operator long() const { return n; }
+};
+
+template<> struct Counter<false> {
+    void operator++(int) {}
+    operator long() const { return 0; }
+};
+
+/*
+ * What Node has always done:
+ *  - delayed:    layer messages are delivered after a random (or adversarial) delay, not immediately
+ *  - gui:        bubbles and parent path colouring for Qtenv
+ *  - statistics: message counters recorded as scalars in finish()
+ *  - options:    the protocol variants selected by NED parameters (piggyback, dropStale, layerPriority, dag, delayMode, bundling,
+ *                repair, maxLayer, aggregation, routing, diameter)
+ *  - profiling:  call counts and CPU cycles of the handlers (see profiler.h); off, it costs nothing
+ */
+struct DefaultPolicy {
+    static const bool delayed = true;
+    static const bool gui = true;
+    static const bool statistics = true;
+    static const bool options = true;
+    static const bool profiling = false;
+};
+
+/*
+ * Same as DefaultPolicy, but every message is sent without delay.
+ */
+struct ImmediatePolicy : DefaultPolicy {
+    static const bool delayed = false;
+};
+
+/*
+ * Same as DefaultPolicy, with the handlers instrumented.
+ */
+struct ProfilingPolicy : DefaultPolicy {
+    static const bool profiling = true;
+};
+
+/*
+ * Bare algorithm for large batch runs: no GUI feedback, no statistics and no protocol variants.
+ */
+struct FastPolicy {
+    static const bool delayed = true;
+    static const bool gui = false;
+    static const bool statistics = false;
+    static const bool options = false;
+    static const bool profiling = false;
+};
+
+#endif /* POLICY_H_ */
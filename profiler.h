@@ -0,0 +1,95 @@
+/*
+ * profiler.h
+ *
+ * Call counts and CPU cycles of the node's handlers and helpers, for the profiling policy only.
+ * With profiling off, Profiler and ProfileScope are empty and every scope compiles away.
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <omnetpp.h>
+#include <stdint.h>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+using namespace omnetpp;
+
+/*
+ * What gets timed. Scopes nest, so the time of a handler includes that of the helpers it calls.
+ */
+enum ProfileSlot {
+    PROFILE_HANDLE_MESSAGE,     // handleMessage(), everything included
+    PROFILE_DISPATCH,           // dispatch(), the stale check and the handler it calls
+    PROFILE_HANDLE_LAYER,
+    PROFILE_HANDLE_ACK,
+    PROFILE_HANDLE_REJECT,
+    PROFILE_SET_PARENT,
+    PROFILE_PARENT_CHECK,       // Cross-module lookup of the sender's parent before a reject
+    PROFILE_LIST_SEARCH,        // std::find on the children/other lists
+    PROFILE_SEND,               // Handing a message to the transport or the simulation kernel
+    PROFILE_BROADCAST,          // broadcastLayer(), sends included
+    PROFILE_SLOTS
+};
+
+/*
+ * Time stamp counter where there is one (cycles), steady_clock nanoseconds elsewhere.
+ */
+inline uint64_t profileClock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template<bool enabled> struct Profiler {
+    long calls[PROFILE_SLOTS] = {};
+    uint64_t cycles[PROFILE_SLOTS] = {};
+
+    /*
+     * Records `<slot>Calls` and `<slot>Cycles` for every slot that has been entered.
+     */
+    void record(cComponent *component) const {
+        static const char *names[PROFILE_SLOTS] = {
+            "handleMessage", "dispatch", "handleLayer", "handleAck", "handleReject",
+            "setParent", "parentCheck", "listSearch", "send", "broadcastLayer"
+        };
+        for(int i = 0; i < PROFILE_SLOTS; i++) {
+            if(calls[i] == 0)
+                continue;
+            component->recordScalar((std::string(names[i]) + "Calls").c_str(), calls[i]);
+            component->recordScalar((std::string(names[i]) + "Cycles").c_str(), (double)cycles[i]);
+        }
+    }
+};
+
+template<> struct Profiler<false> {
+    void record(cComponent *component) const {}
+};
+
+/*
+ * Counts a call of `slot` and adds the cycles until the end of the enclosing block.
+ */
+template<bool enabled> class ProfileScope {
+    Profiler<true>& profiler;
+    ProfileSlot slot;
+    uint64_t start;
+public:
+    ProfileScope(Profiler<true>& profiler, ProfileSlot slot) : profiler(profiler), slot(slot), start(profileClock()) {}
+    ~ProfileScope() {
+        profiler.calls[slot]++;
+        profiler.cycles[slot] += profileClock() - start;
+    }
+};
+
+template<> class ProfileScope<false> {
+public:
+    ProfileScope(Profiler<false>& profiler, ProfileSlot slot) {}
+};
+
+#endif /* PROFILER_H_ */
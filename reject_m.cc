@@ -179,11 +179,12 @@ inline std::ostream& operator<<(std::ostream& out, const std::vector<T,A>& vec)
 
 Register_Class(rejectMessage)
 
-rejectMessage::rejectMessage(const char *name, short kind) : ::omnetpp::cMessage(name,kind)
+rejectMessage::rejectMessage(const char *name, short kind) : ::omnetpp::cPacket(name,kind)
 {
+    this->seq = 0;
 }
 
-rejectMessage::rejectMessage(const rejectMessage& other) : ::omnetpp::cMessage(other)
+rejectMessage::rejectMessage(const rejectMessage& other) : ::omnetpp::cPacket(other)
 {
     copy(other);
 }
@@ -195,23 +196,36 @@ rejectMessage::~rejectMessage()
 rejectMessage& rejectMessage::operator=(const rejectMessage& other)
 {
     if (this==&other) return *this;
-    ::omnetpp::cMessage::operator=(other);
+    ::omnetpp::cPacket::operator=(other);
     copy(other);
     return *this;
 }
 
 void rejectMessage::copy(const rejectMessage& other)
 {
+    this->seq = other.seq;
 }
 
 void rejectMessage::parsimPack(omnetpp::cCommBuffer *b) const
 {
-    ::omnetpp::cMessage::parsimPack(b);
+    ::omnetpp::cPacket::parsimPack(b);
+    doParsimPacking(b,this->seq);
 }
 
 void rejectMessage::parsimUnpack(omnetpp::cCommBuffer *b)
 {
-    ::omnetpp::cMessage::parsimUnpack(b);
+    ::omnetpp::cPacket::parsimUnpack(b);
+    doParsimUnpacking(b,this->seq);
+}
+
+unsigned int rejectMessage::getSeq() const
+{
+    return this->seq;
+}
+
+void rejectMessage::setSeq(unsigned int seq)
+{
+    this->seq = seq;
 }
 
 class rejectMessageDescriptor : public omnetpp::cClassDescriptor
@@ -244,7 +258,7 @@ class rejectMessageDescriptor : public omnetpp::cClassDescriptor
 
 Register_ClassDescriptor(rejectMessageDescriptor)
 
-rejectMessageDescriptor::rejectMessageDescriptor() : omnetpp::cClassDescriptor("rejectMessage", "omnetpp::cMessage")
+rejectMessageDescriptor::rejectMessageDescriptor() : omnetpp::cClassDescriptor("rejectMessage", "omnetpp::cPacket")
 {
     propertynames = nullptr;
 }
@@ -279,7 +293,7 @@ const char *rejectMessageDescriptor::getProperty(const char *propertyname) const
 int rejectMessageDescriptor::getFieldCount() const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
-    return basedesc ? 0+basedesc->getFieldCount() : 0;
+    return basedesc ? 1+basedesc->getFieldCount() : 1;
 }
 
 unsigned int rejectMessageDescriptor::getFieldTypeFlags(int field) const
@@ -290,7 +304,10 @@ unsigned int rejectMessageDescriptor::getFieldTypeFlags(int field) const
             return basedesc->getFieldTypeFlags(field);
         field -= basedesc->getFieldCount();
     }
-    return 0;
+    static unsigned int fieldTypeFlags[] = {
+        FD_ISEDITABLE,
+    };
+    return (field>=0 && field<1) ? fieldTypeFlags[field] : 0;
 }
 
 const char *rejectMessageDescriptor::getFieldName(int field) const
@@ -301,12 +318,17 @@ const char *rejectMessageDescriptor::getFieldName(int field) const
             return basedesc->getFieldName(field);
         field -= basedesc->getFieldCount();
     }
-    return nullptr;
+    static const char *fieldNames[] = {
+        "seq",
+    };
+    return (field>=0 && field<1) ? fieldNames[field] : nullptr;
 }
 
 int rejectMessageDescriptor::findField(const char *fieldName) const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
+    int base = basedesc ? basedesc->getFieldCount() : 0;
+    if (fieldName[0]=='s' && strcmp(fieldName, "seq")==0) return base+0;
     return basedesc ? basedesc->findField(fieldName) : -1;
 }
 
@@ -318,7 +340,10 @@ const char *rejectMessageDescriptor::getFieldTypeString(int field) const
             return basedesc->getFieldTypeString(field);
         field -= basedesc->getFieldCount();
     }
-    return nullptr;
+    static const char *fieldTypeStrings[] = {
+        "unsigned int",
+    };
+    return (field>=0 && field<1) ? fieldTypeStrings[field] : nullptr;
 }
 
 const char **rejectMessageDescriptor::getFieldPropertyNames(int field) const
@@ -385,6 +410,7 @@ std::string rejectMessageDescriptor::getFieldValueAsString(void *object, int fie
     }
     rejectMessage *pp = (rejectMessage *)object; (void)pp;
     switch (field) {
+        case 0: return ulong2string(pp->getSeq());
         default: return "";
     }
 }
@@ -399,6 +425,7 @@ bool rejectMessageDescriptor::setFieldValueAsString(void *object, int field, int
     }
     rejectMessage *pp = (rejectMessage *)object; (void)pp;
     switch (field) {
+        case 0: pp->setSeq(string2ulong(value)); return true;
         default: return false;
     }
 }
@@ -411,7 +438,9 @@ const char *rejectMessageDescriptor::getFieldStructName(int field) const
             return basedesc->getFieldStructName(field);
         field -= basedesc->getFieldCount();
     }
-    return nullptr;
+    switch (field) {
+        default: return nullptr;
+    };
 }
 
 void *rejectMessageDescriptor::getFieldStructValuePointer(void *object, int field, int i) const
@@ -21,14 +21,16 @@
 /**
  * Class generated from <tt>reject.msg:1</tt> by nedtool.
  * <pre>
- * message rejectMessage
+ * packet rejectMessage
  * {
+ *     unsigned int seq;
  * }
  * </pre>
  */
-class rejectMessage : public ::omnetpp::cMessage
+class rejectMessage : public ::omnetpp::cPacket
 {
   protected:
+    unsigned int seq;
 
   private:
     void copy(const rejectMessage& other);
@@ -47,6 +49,8 @@ class rejectMessage : public ::omnetpp::cMessage
     virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
 
     // field getter/setter methods
+    virtual unsigned int getSeq() const;
+    virtual void setSeq(unsigned int seq);
 };
 
 inline void doParsimPacking(omnetpp::cCommBuffer *b, const rejectMessage& obj) {obj.parsimPack(b);}
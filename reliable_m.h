@@ -0,0 +1,61 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from reliable.msg.
+//
+
+#ifndef __RELIABLE_M_H
+#define __RELIABLE_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>reliable.msg:1</tt> by nedtool.
+ * <pre>
+ * packet reliableMessage
+ * {
+ *     unsigned int seq;
+ * }
+ * </pre>
+ */
+class reliableMessage : public ::omnetpp::cPacket
+{
+  protected:
+    unsigned int seq;
+
+  private:
+    void copy(const reliableMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const reliableMessage&);
+
+  public:
+    reliableMessage(const char *name=nullptr, short kind=0);
+    reliableMessage(const reliableMessage& other);
+    virtual ~reliableMessage();
+    reliableMessage& operator=(const reliableMessage& other);
+    virtual reliableMessage *dup() const override {return new reliableMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual unsigned int getSeq() const;
+    virtual void setSeq(unsigned int seq);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const reliableMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, reliableMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __RELIABLE_M_H
+
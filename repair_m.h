@@ -0,0 +1,57 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from repair.msg.
+//
+
+#ifndef __REPAIR_M_H
+#define __REPAIR_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>repair.msg:1</tt> by nedtool.
+ * <pre>
+ * packet repairMessage
+ * {
+ * }
+ * </pre>
+ */
+class repairMessage : public ::omnetpp::cPacket
+{
+  protected:
+
+  private:
+    void copy(const repairMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const repairMessage&);
+
+  public:
+    repairMessage(const char *name=nullptr, short kind=0);
+    repairMessage(const repairMessage& other);
+    virtual ~repairMessage();
+    repairMessage& operator=(const repairMessage& other);
+    virtual repairMessage *dup() const override {return new repairMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const repairMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, repairMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __REPAIR_M_H
+
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Replays a snapshot file written by SnapshotRecorder into one frame per snapshot.
+
+    replay_snapshots.py run.snapshots out/            # out/frame-00000.svg, ...
+    replay_snapshots.py --csv run.snapshots out/      # out/frame-00000.csv (node,parent,distance)
+    replay_snapshots.py --every 10 run.snapshots out/ # every 10th frame only (the last one is always written)
+
+SVG frames draw the tree as it was at that time: one row per depth, nodes ordered by index
+within a row, the root (the node at distance 0) in red and unreached nodes on the bottom row in grey. Only the standard library is needed.
+"""
+import argparse
+import gzip
+import math
+import os
+import struct
+import sys
+
+
+def read_varint(f):
+    shift = value = 0
+    while True:
+        b = f.read(1)
+        if not b:
+            raise EOFError
+        value |= (b[0] & 0x7f) << shift
+        if b[0] < 0x80:
+            return value
+        shift += 7
+
+
+def frames(path):
+    """Yields (time, parent, distance) after every frame; the lists are updated in place."""
+    with gzip.open(path, 'rb') as f:
+        if f.read(4) != b'BFSS':
+            sys.exit('%s: not a snapshot file' % path)
+        version, count = struct.unpack('<ii', f.read(8))
+        if version != 1:
+            sys.exit('%s: unsupported version %d' % (path, version))
+        parent = [-1] * count
+        distance = [math.inf] * count
+        while True:
+            head = f.read(8)
+            if not head:
+                return
+            (time,) = struct.unpack('<d', head)
+            node = -1
+            for _ in range(read_varint(f)):
+                node += read_varint(f)
+                parent[node] = read_varint(f) - 1
+                (distance[node],) = struct.unpack('<d', f.read(8))
+            yield time, parent, distance
+
+
+def depths(parent):
+    depth = [None] * len(parent)
+    for start in range(len(parent)):
+        path = []
+        n = start
+        while n != -1 and depth[n] is None:
+            path.append(n)
+            n = parent[n]
+        d = -1 if n == -1 else depth[n]
+        for n in reversed(path):
+            d += 1
+            depth[n] = d
+    return depth
+
+
+def write_svg(path, time, parent, distance):
+    depth = depths(parent)
+    root = {i for i in range(len(parent)) if distance[i] == 0}     # Empty while the root is down
+    reached = [i for i in range(len(parent)) if i in root or parent[i] != -1]
+    rows = {}
+    for i in reached:
+        rows.setdefault(depth[i], []).append(i)
+    unreached = [i for i in range(len(parent)) if i not in root and parent[i] == -1]
+    if unreached:
+        rows[max(rows, default=-1) + 1] = unreached
+    width = max((len(r) for r in rows.values()), default=1)
+    step, margin = 12, 20
+    pos = {}
+    for d, row in rows.items():
+        offset = (width - len(row)) * step / 2
+        for k, i in enumerate(sorted(row)):
+            pos[i] = (margin + offset + k * step, margin + 40 + d * 4 * step)
+    w = 2 * margin + width * step
+    h = 2 * margin + 40 + len(rows) * 4 * step
+    with open(path, 'w') as out:
+        out.write('<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d">\n' % (w, h))
+        out.write('<text x="%d" y="%d" font-size="14">t = %g</text>\n' % (margin, margin, time))
+        for i in reached:
+            if parent[i] != -1:
+                (x1, y1), (x2, y2) = pos[i], pos[parent[i]]
+                out.write('<line x1="%g" y1="%g" x2="%g" y2="%g" stroke="red"/>\n' % (x1, y1, x2, y2))
+        for i, (x, y) in pos.items():
+            colour = 'grey' if i in unreached else ('red' if i in root else 'black')
+            out.write('<circle cx="%g" cy="%g" r="3" fill="%s"><title>node[%d] %g</title></circle>\n' % (x, y, colour, i, distance[i]))
+        out.write('</svg>\n')
+
+
+def write_csv(path, time, parent, distance):
+    with open(path, 'w') as out:
+        out.write('# t = %r\nnode,parent,distance\n' % time)
+        for i in range(len(parent)):
+            out.write('%d,%d,%r\n' % (i, parent[i], distance[i]))
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Replay SnapshotRecorder output into SVG or CSV frames.')
+    ap.add_argument('snapshots')
+    ap.add_argument('outdir')
+    ap.add_argument('--csv', action='store_true', help='write CSV frames instead of SVG')
+    ap.add_argument('--every', type=int, default=1, help='write every n-th frame only')
+    args = ap.parse_args()
+
+    os.makedirs(args.outdir, exist_ok=True)
+    write = write_csv if args.csv else write_svg
+    ext = 'csv' if args.csv else 'svg'
+    last = None
+    for k, (time, parent, distance) in enumerate(frames(args.snapshots)):
+        last = (k, time, parent, distance)
+        if k % args.every == 0:
+            write(os.path.join(args.outdir, 'frame-%05d.%s' % (k, ext)), time, parent, distance)
+    if last and last[0] % args.every != 0:
+        write(os.path.join(args.outdir, 'frame-%05d.%s' % (last[0], ext)), *last[1:])
+
+
+if __name__ == '__main__':
+    main()
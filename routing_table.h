@@ -0,0 +1,54 @@
+/*
+ * routing_table.h
+ *
+ * Next-hop table of a node, from the interval labelling of the tree, see BFSNode::assignLabels().
+ */
+
+#ifndef ROUTING_TABLE_H_
+#define ROUTING_TABLE_H_
+
+#include <algorithm>
+#include <vector>
+
+/*
+ * The nodes of the tree are numbered in depth-first order, so the labels of every subtree form one
+ * interval: ours is [label, end), and the intervals of our children split (label, end) between them.
+ * A destination in one of those goes down through that child's port, anything else goes up.
+ * The table has one entry per child, and a lookup is a binary search over their starts.
+ */
+struct RoutingTable {
+    struct Range {
+        int start;
+        int end;
+        int port;
+    };
+
+    static const int LOCAL = -2;    // lookup(): the destination is this node
+
+    int label = -1;                 // Ours, -1 until the first labelling
+    int end = 0;                    // One past the last label of our subtree
+    int up = -1;                    // Port towards the root, -1 at the root
+    std::vector<Range> down;        // Intervals of our children, by increasing start
+
+    void clear() {
+        label = -1;
+        end = 0;
+        up = -1;
+        down.clear();
+    }
+
+    /*
+     * Port to forward a packet for `destination` through, LOCAL if it is ours, -1 if there is none.
+     */
+    int lookup(int destination) const {
+        if(destination == label)
+            return LOCAL;
+        if(destination < label || destination >= end)
+            return up;
+        std::vector<Range>::const_iterator it = std::upper_bound(down.begin(), down.end(), destination,
+                [](int d, const Range& r) { return d < r.start; });
+        return it == down.begin() || destination >= (it - 1)->end ? -1 : (it - 1)->port;
+    }
+};
+
+#endif /* ROUTING_TABLE_H_ */
@@ -0,0 +1,49 @@
+#!/bin/sh
+#
+# Runs the Differential and DifferentialWeighted configurations in Cmdenv and
+# summarizes the checker scalars per variant. Exits non-zero if any run failed.
+#
+# usage: ./run_differential.sh [-j jobs] [extra Cmdenv options...]
+#        e.g. ./run_differential.sh -j 8 -r '0..99'
+#
+
+cd "$(dirname "$0")" || exit 1
+JOBS=1
+if [ "$1" = "-j" ]; then
+    JOBS=$2
+    shift 2
+fi
+
+status=0
+for config in Differential DifferentialWeighted; do
+    rm -f results/$config-*.sca
+    if command -v opp_runall >/dev/null 2>&1 && [ "$JOBS" -gt 1 ]; then
+        opp_runall -j"$JOBS" ./async_bfs -u Cmdenv -c $config "$@" || status=1
+    else
+        ./async_bfs -u Cmdenv -c $config "$@" || status=1
+    fi
+done
+
+# One line per variant: runs, events, wall time and tree errors, summed over the runs
+awk '
+    FNR == 1 { key = ""; variant = options = "" }
+    /^attr / { value = $3; gsub(/[\\"]/, "", value) }       # Iteration variables, unquoted
+    /^attr variant / { variant = value }
+    /^attr (piggyback|dropStale|dag|layerPriority|reliable) / && value == "true" { options = options "+" $2 }
+    /^attr maxLayer / && value != "-1" { options = options "+maxLayer=" value }
+    /^attr (bundling|delayMode) / && value != "none" && value != "uniform" { options = options "+" value }
+    /^scalar .*\.checker / {
+        if(key == "")
+            key = variant options
+        sum[key, $3] += $4
+        if($3 == "wallTime")
+            runs[key]++
+    }
+    END {
+        printf "%-32s %6s %14s %10s %8s %8s %8s %8s\n", "variant", "runs", "events", "wallTime", "distErr", "parErr", "childErr", "dagErr"
+        for(k in runs)
+            printf "%-32s %6d %14d %10.3f %8d %8d %8d %8d\n", k, runs[k], sum[k, "events"], sum[k, "wallTime"], sum[k, "distanceErrors"], sum[k, "parentErrors"], sum[k, "childErrors"], sum[k, "dagErrors"]
+    }
+' results/Differential-*.sca results/DifferentialWeighted-*.sca
+
+exit $status
@@ -0,0 +1,117 @@
+/*
+ * snapshot_recorder.cc
+ *
+ * Records how the BFS tree evolves, as periodic delta-encoded snapshots in one gzip file,
+ * for offline animation with replay_snapshots.py.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "snapshot_recorder.h"
+#include "async_bfs.h"
+
+Define_Module(SnapshotRecorder);
+
+static const char SNAPSHOT_MAGIC[4] = { 'B', 'F', 'S', 'S' };
+static const int32_t SNAPSHOT_VERSION = 1;
+
+SnapshotRecorder::~SnapshotRecorder() {
+    cancelAndDelete(timer);
+    if(file)
+        gzclose(file);
+}
+
+void SnapshotRecorder::initialize() {
+    const char *fileName = par("snapshotFile").stringValue();
+    if(!*fileName)
+        return;
+    interval = par("snapshotInterval");
+    if(interval <= SIMTIME_ZERO)
+        throw cRuntimeError("snapshotInterval must be positive");
+    file = gzopen(fileName, "wb");
+    if(!file)
+        throw cRuntimeError("Cannot open `%s' for writing", fileName);
+
+    nodeCount = getParentModule()->par("nodeCount").intValue();
+    lastParent.assign(nodeCount, -1);
+    lastDistance.assign(nodeCount, INFINITY);
+
+    std::vector<unsigned char> header(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC));
+    putInt(header, SNAPSHOT_VERSION);
+    putInt(header, nodeCount);
+    gzwrite(file, header.data(), header.size());
+
+    timer = new cMessage("snapshot");
+    scheduleAt(simTime() + interval, timer);
+}
+
+void SnapshotRecorder::handleMessage(cMessage *msg) {
+    writeFrame();
+    if(!getSimulation()->getFES()->isEmpty())
+        scheduleAt(simTime() + interval, timer);
+}
+
+void SnapshotRecorder::finish() {
+    if(!file)
+        return;
+    writeFrame();
+    gzclose(file);
+    file = nullptr;
+    recordScalar("snapshotFrames", framesWritten);
+}
+
+/*
+ * Scans the nodes and writes a frame with the ones that changed, if any.
+ */
+void SnapshotRecorder::writeFrame() {
+    cModule *network = getParentModule();
+    changes.clear();
+    long count = 0;
+    int previous = -1;
+    for(int i = 0; i < nodeCount; i++) {
+        TreeNode *n = check_and_cast<TreeNode *>(network->getSubmodule("node", i));
+        int parent = n->getParentNode();
+        double distance = n->getDistance();
+        if(parent == lastParent[i] && (distance == lastDistance[i] || (isinf(distance) && isinf(lastDistance[i]))))
+            continue;
+        putVarint(changes, i - previous);
+        putVarint(changes, parent + 1);
+        putDouble(changes, distance);
+        lastParent[i] = parent;
+        lastDistance[i] = distance;
+        previous = i;
+        count++;
+    }
+    if(count == 0)
+        return;
+
+    std::vector<unsigned char> header;
+    putDouble(header, simTime().dbl());
+    putVarint(header, count);
+    gzwrite(file, header.data(), header.size());
+    gzwrite(file, changes.data(), changes.size());
+    framesWritten++;
+}
+
+void SnapshotRecorder::putVarint(std::vector<unsigned char>& out, uint64_t v) {
+    while(v >= 0x80) {
+        out.push_back((unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((unsigned char)v);
+}
+
+/*
+ * The IEEE 754 bits of `d`, little-endian whatever the host.
+ */
+void SnapshotRecorder::putDouble(std::vector<unsigned char>& out, double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(d));
+    for(size_t i = 0; i < sizeof(bits); i++)
+        out.push_back((unsigned char)(bits >> (8 * i)));
+}
+
+void SnapshotRecorder::putInt(std::vector<unsigned char>& out, int32_t v) {
+    for(size_t i = 0; i < sizeof(v); i++)
+        out.push_back((unsigned char)((uint32_t)v >> (8 * i)));
+}
@@ -0,0 +1,51 @@
+/*
+ * snapshot_recorder.h
+ *
+ * Records how the BFS tree evolves, as periodic delta-encoded snapshots in one gzip file,
+ * for offline animation with replay_snapshots.py.
+ */
+
+#ifndef SNAPSHOT_RECORDER_H_
+#define SNAPSHOT_RECORDER_H_
+
+#include <omnetpp.h>
+#include <stdint.h>
+#include <vector>
+#include <zlib.h>
+
+using namespace omnetpp;
+
+/*
+ * Every `snapshotInterval` of simulated time, compares the (parent node, distance) of every node
+ * with what it wrote last time and appends the differences as a frame to `snapshotFile` (gzip):
+ *  - header: "BFSS" magic, int32 version (1), int32 node count
+ *  - frame:  float64 time, varint change count, then per change, in increasing node order:
+ *            varint node delta (from the previous change of the frame, or from -1),
+ *            varint parent node + 1 (0 for none), float64 distance (inf if not reached)
+ * Varints are LEB128, numbers are little endian. The first frame holds every node that has
+ * a parent or a distance; the last one is written in finish(). An empty file name disables recording.
+ * The recorder stops rescheduling itself once nothing else is left in the future event set.
+ */
+class SnapshotRecorder : public cSimpleModule {
+    gzFile file = nullptr;
+    simtime_t interval;
+    cMessage *timer = nullptr;
+    int nodeCount = 0;
+    std::vector<int> lastParent;        // As written to the file so far
+    std::vector<double> lastDistance;
+    std::vector<unsigned char> changes; // Encoded changes of the frame being written
+    long framesWritten = 0;
+
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+
+    void writeFrame();
+    static void putVarint(std::vector<unsigned char>& out, uint64_t v);
+    static void putDouble(std::vector<unsigned char>& out, double d);
+    static void putInt(std::vector<unsigned char>& out, int32_t v);
+public:
+    virtual ~SnapshotRecorder();
+};
+
+#endif /* SNAPSHOT_RECORDER_H_ */
@@ -0,0 +1,65 @@
+//
+// Generated file, do not edit! Created by nedtool 5.5 from sweep.msg.
+//
+
+#ifndef __SWEEP_M_H
+#define __SWEEP_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0505
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+/**
+ * Class generated from <tt>sweep.msg:1</tt> by nedtool.
+ * <pre>
+ * packet sweepMessage
+ * {
+ *     unsigned int round;
+ *     int distance;
+ * }
+ * </pre>
+ */
+class sweepMessage : public ::omnetpp::cPacket
+{
+  protected:
+    unsigned int round;
+    int distance;
+
+  private:
+    void copy(const sweepMessage& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const sweepMessage&);
+
+  public:
+    sweepMessage(const char *name=nullptr, short kind=0);
+    sweepMessage(const sweepMessage& other);
+    virtual ~sweepMessage();
+    sweepMessage& operator=(const sweepMessage& other);
+    virtual sweepMessage *dup() const override {return new sweepMessage(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual unsigned int getRound() const;
+    virtual void setRound(unsigned int round);
+    virtual int getDistance() const;
+    virtual void setDistance(int distance);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const sweepMessage& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, sweepMessage& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __SWEEP_M_H
+
@@ -0,0 +1,111 @@
+/*
+ * timer_wheel.h
+ *
+ * Hashed timer wheel: all the timers of a node behind a single self-message.
+ */
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <omnetpp.h>
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+using namespace omnetpp;
+
+/*
+ * Time is cut into ticks of `resolution`; a timer goes into slot (tick % slot count) and fires on
+ * the first tick at or after its deadline. Timers more than one revolution away share a slot with
+ * nearer ones and are skipped until their own tick comes. Cancelling is left to the owner: it
+ * simply ignores timers whose subject is gone when they fire, or drops a whole port's at once.
+ */
+class TimerWheel {
+public:
+    struct Timer {
+        int64_t tick;
+        int port;
+        uint32_t seq;
+    };
+private:
+    simtime_t resolution;
+    std::vector<std::vector<Timer>> slots;
+    long count = 0;
+    int64_t nextTick = 0;           // First tick not expired yet
+public:
+    void init(simtime_t resolution, int slotCount) {
+        this->resolution = resolution;
+        slots.assign(slotCount, std::vector<Timer>());
+    }
+    bool empty() const { return count == 0; }
+
+    void add(simtime_t deadline, int port, uint32_t seq) {
+        int64_t tick = (int64_t)ceil(deadline / resolution);
+        if(tick < nextTick)
+            tick = nextTick;
+        slots[tick % slots.size()].push_back(Timer{tick, port, seq});
+        count++;
+    }
+
+    /*
+     * When the wheel needs to wake up next: the first slot within one revolution holding a timer
+     * of its own tick, or else the earliest timer of all.
+     */
+    simtime_t nextDeadline() const {
+        int64_t best = INT64_MAX;
+        for(size_t k = 0; k < slots.size() && best == INT64_MAX; k++) {
+            const std::vector<Timer>& slot = slots[(nextTick + k) % slots.size()];
+            for(size_t i = 0; i < slot.size(); i++)
+                if(slot[i].tick == nextTick + (int64_t)k)
+                    best = slot[i].tick;
+        }
+        for(size_t s = 0; s < slots.size() && best == INT64_MAX; s++)
+            for(size_t i = 0; i < slots[s].size(); i++)
+                best = std::min(best, slots[s][i].tick);
+        return resolution * (double)best;
+    }
+
+    /*
+     * Drops every timer of `port`, whose link has gone away with all that was waiting on it.
+     */
+    void remove(int port) {
+        for(size_t s = 0; s < slots.size(); s++) {
+            size_t kept = 0;
+            for(size_t i = 0; i < slots[s].size(); i++)
+                if(slots[s][i].port != port)
+                    slots[s][kept++] = slots[s][i];
+            count -= slots[s].size() - kept;
+            slots[s].resize(kept);
+        }
+    }
+
+    void clear() {
+        for(size_t s = 0; s < slots.size(); s++)
+            slots[s].clear();
+        count = 0;
+    }
+
+    /*
+     * Moves every timer due at `now` to `due`.
+     */
+    void expire(simtime_t now, std::vector<Timer>& due) {
+        int64_t last = (int64_t)floor(now / resolution);
+        int64_t first = std::max(nextTick, last - (int64_t)slots.size() + 1);
+        for(int64_t t = first; t <= last; t++) {
+            std::vector<Timer>& slot = slots[t % slots.size()];
+            size_t kept = 0;
+            for(size_t i = 0; i < slot.size(); i++) {
+                if(slot[i].tick <= last)
+                    due.push_back(slot[i]);
+                else
+                    slot[kept++] = slot[i];
+            }
+            count -= slot.size() - kept;
+            slot.resize(kept);
+        }
+        nextTick = std::max(nextTick, last + 1);
+    }
+};
+
+#endif /* TIMER_WHEEL_H_ */
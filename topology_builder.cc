@@ -0,0 +1,328 @@
+/*
+ * topology_builder.cc
+ *
+ * Builds the connections of AsyncBFSNet for the topologies that can't be expressed
+ * in NED efficiently, and reports how much of the graph the root can reach.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_set>
+#include "topology_builder.h"
+
+Define_Module(TopologyBuilder);
+
+void TopologyBuilder::initialize(int stage) {
+    if(stage != 0)
+        return;
+
+    cModule *network = getParentModule();
+    nodeCount = network->par("nodeCount").intValue();
+    const char *topology = network->par("topology").stringValue();
+    double connectedness = network->par("connectedness").doubleValue();
+    weightedLinks = network->par("weightedLinks").boolValue();
+
+    if(strcmp(topology, "erdosRenyi") == 0)
+        ;                                                   // Already connected by the NED connections section
+    else if(strcmp(topology, "connectedErdosRenyi") == 0)
+        buildConnectedErdosRenyi(connectedness);
+    else if(strcmp(topology, "barabasiAlbert") == 0)
+        buildBarabasiAlbert(par("baEdges").intValue());
+    else if(strcmp(topology, "wattsStrogatz") == 0)
+        buildWattsStrogatz(par("wsNeighbours").intValue(), par("wsRewire").doubleValue());
+    else if(strcmp(topology, "grid") == 0 || strcmp(topology, "torus") == 0)
+        buildGrid(par("gridDimensions").intValue(), strcmp(topology, "torus") == 0);
+    else if(strcmp(topology, "geometric") == 0)
+        buildGeometric(par("geometricRadius").doubleValue());
+    else
+        throw cRuntimeError("Unknown topology `%s'", topology);
+
+    countComponents();
+    EV << "Topology: " << components << " component(s), " << reachable << " of " << nodeCount << " node(s) reachable from the root" << std::endl;
+
+    if(components > 1 && par("skipDisconnected").boolValue())
+        scheduleAt(simTime(), new cMessage("skipDisconnected"));
+}
+
+/*
+ * The only message we ever get is the one scheduled for disconnected topologies.
+ */
+void TopologyBuilder::handleMessage(cMessage *msg) {
+    delete msg;
+    EV << "Topology is disconnected, ending the simulation." << std::endl;
+    endSimulation();
+}
+
+void TopologyBuilder::finish() {
+    recordScalar("reachableNodes", reachable);
+    recordScalar("unreachableNodes", nodeCount - reachable);
+    recordScalar("components", components);
+    recordScalar("largestComponent", largestComponent);
+}
+
+/*
+ * The nodes bound their distances with it (see BFSNode::initialize()); it takes one pass over
+ * the links for each parameter, however many nodes ask. Without a parameter every link weighs 1.
+ */
+double TopologyBuilder::getHeaviestLink(const char *parName) {
+    Enter_Method_Silent();
+    if(!parName)
+        return 1;
+    std::map<std::string, double>::iterator it = heaviest.find(parName);
+    if(it != heaviest.end())
+        return it->second;
+    double max = 0;
+    for(int i = 0; i < nodeCount; i++) {
+        cModule *n = node(i);
+        for(int p = 0; p < n->gateSize("port"); p++) {
+            cChannel *channel = n->gate("port$o", p)->getChannel();
+            if(channel && channel->hasPar(parName))
+                max = std::max(max, channel->par(parName).doubleValue());
+        }
+    }
+    heaviest[parName] = max;
+    return max;
+}
+
+cModule *TopologyBuilder::node(int i) {
+    return getParentModule()->getSubmodule("node", i);
+}
+
+/*
+ * Adds a bidirectional connection between node[i] and node[j], the same way
+ * `node[i].port++ <--> node[j].port++` does in NED, through a pair of Link channels if `weightedLinks` is set.
+ */
+void TopologyBuilder::connect(int i, int j) {
+    cGate *iIn, *iOut, *jIn, *jOut;
+    node(i)->getOrCreateFirstUnconnectedGatePair("port", false, true, iIn, iOut);
+    node(j)->getOrCreateFirstUnconnectedGatePair("port", false, true, jIn, jOut);
+    if(weightedLinks) {
+        iOut->connectTo(jIn, cChannelType::get("Link")->create("channel"));
+        jOut->connectTo(iIn, cChannelType::get("Link")->create("channel"));
+        iOut->getChannel()->callInitialize();
+        jOut->getChannel()->callInitialize();
+    } else {
+        iOut->connectTo(jIn);
+        jOut->connectTo(iIn);
+    }
+}
+
+/*
+ * Random spanning tree over a random permutation of the nodes (every node attaches to a uniformly
+ * chosen node placed before it), then every remaining pair is connected with probability p.
+ * The extras are drawn with geometric skipping (Batagelj & Brandes), so the cost is O(N + M)
+ * instead of going through all N^2 pairs.
+ */
+void TopologyBuilder::buildConnectedErdosRenyi(double p) {
+    std::vector<int> order(nodeCount);
+    for(int i = 0; i < nodeCount; i++)
+        order[i] = i;
+    for(int i = nodeCount - 1; i > 0; i--)
+        std::swap(order[i], order[intuniform(0, i)]);
+
+    std::vector<int> treeParent(nodeCount, -1);
+    for(int k = 1; k < nodeCount; k++) {
+        int v = order[k], w = order[intuniform(0, k - 1)];
+        treeParent[v] = w;
+        connect(v, w);
+    }
+
+    if(p <= 0)
+        return;
+    double logq = p < 1 ? log(1 - p) : 0;
+    long v = 1, w = -1;
+    while(v < nodeCount) {
+        w += p < 1 ? 1 + (long)floor(log(1 - uniform(0, 1)) / logq) : 1;
+        while(w >= v && v < nodeCount) {
+            w -= v;
+            v++;
+        }
+        if(v < nodeCount && treeParent[v] != w && treeParent[w] != v)
+            connect(v, w);
+    }
+}
+
+/*
+ * Preferential attachment over a random permutation of the nodes, so that the root isn't always
+ * one of the oldest hubs. The first node after the m initial ones links to all of them; every
+ * later node links to m distinct nodes picked with probability proportional to their degree,
+ * i.e. uniformly from `ends`, which lists every node once per link it has.
+ */
+void TopologyBuilder::buildBarabasiAlbert(int m) {
+    if(m < 1)
+        throw cRuntimeError("baEdges must be at least 1");
+    std::vector<int> order(nodeCount);
+    for(int i = 0; i < nodeCount; i++)
+        order[i] = i;
+    for(int i = nodeCount - 1; i > 0; i--)
+        std::swap(order[i], order[intuniform(0, i)]);
+
+    std::vector<int> ends;
+    ends.reserve(2 * (size_t)m * nodeCount);
+    std::vector<int> targets;
+    for(int k = m; k < nodeCount; k++) {
+        targets.clear();
+        if(k == m) {
+            for(int j = 0; j < m; j++)
+                targets.push_back(order[j]);
+        } else {
+            while((int)targets.size() < m) {
+                int t = ends[intuniform(0, ends.size() - 1)];
+                if(std::find(targets.begin(), targets.end(), t) == targets.end())
+                    targets.push_back(t);
+            }
+        }
+        for(size_t j = 0; j < targets.size(); j++) {
+            connect(order[k], targets[j]);
+            ends.push_back(order[k]);
+            ends.push_back(targets[j]);
+        }
+    }
+}
+
+/*
+ * Ring lattice where every node links to its k nearest neighbours on each side; then the far end
+ * of every link is moved, with probability beta, to a uniformly chosen node it isn't linked to yet;
+ * a node that is already linked to every other one keeps the link as it is.
+ * Links are collected first and connected at the end, since rewiring has to see the whole lattice.
+ */
+void TopologyBuilder::buildWattsStrogatz(int k, double beta) {
+    if(k < 1 || 2 * k >= nodeCount - 1)
+        throw cRuntimeError("wsNeighbours must be between 1 and (nodeCount - 2) / 2");
+    std::vector<std::pair<int, int>> links;
+    std::unordered_set<uint64_t> linked;
+    std::vector<int> degree(nodeCount, 2 * k);
+    links.reserve((size_t)k * nodeCount);
+    linked.reserve((size_t)k * nodeCount);
+    auto key = [](int a, int b) { return a < b ? (uint64_t)a << 32 | b : (uint64_t)b << 32 | a; };
+
+    for(int i = 0; i < nodeCount; i++)
+        for(int j = 1; j <= k; j++) {
+            links.push_back(std::make_pair(i, (i + j) % nodeCount));
+            linked.insert(key(i, (i + j) % nodeCount));
+        }
+    for(size_t l = 0; l < links.size(); l++) {
+        if(uniform(0, 1) >= beta)
+            continue;
+        int i = links[l].first, w;
+        if(degree[i] >= nodeCount - 1)                      // No unlinked node left to pick
+            continue;
+        do
+            w = intuniform(0, nodeCount - 1);
+        while(w == i || linked.count(key(i, w)));
+        linked.erase(key(i, links[l].second));
+        linked.insert(key(i, w));
+        degree[links[l].second]--;
+        degree[w]++;
+        links[l].second = w;
+    }
+    for(size_t l = 0; l < links.size(); l++)
+        connect(links[l].first, links[l].second);
+}
+
+/*
+ * Lattice with side ceil(nodeCount^(1/dimensions)), filled in row-major order; if nodeCount isn't
+ * a perfect power the last rows are incomplete and miss the links (and wraparounds) to absent nodes.
+ * Sides of 2 get no wraparound, which would only duplicate the existing link.
+ */
+void TopologyBuilder::buildGrid(int dimensions, bool torus) {
+    if(dimensions != 2 && dimensions != 3)
+        throw cRuntimeError("gridDimensions must be 2 or 3");
+    int side = (int)ceil(pow(nodeCount, 1.0 / dimensions) - 1e-9);
+    int stride[3] = { 1, side, side * side };
+
+    for(int i = 0; i < nodeCount; i++) {
+        for(int d = 0; d < dimensions; d++) {
+            int c = i / stride[d] % side;
+            if(c + 1 < side && i + stride[d] < nodeCount)
+                connect(i, i + stride[d]);
+            else if(torus && c + 1 == side && side > 2)
+                connect(i, i - c * stride[d]);
+        }
+        if(getEnvir()->isGUI())
+            setPosition(i, i % side + 0.5 * (i / stride[2] % side), i / side % side + 0.3 * (i / stride[2] % side));
+    }
+}
+
+/*
+ * Random geometric graph: nodes placed uniformly in the unit square, linked when closer than `radius`.
+ * Nodes are hashed into square cells of side `radius` (counting sort), so each node is only compared
+ * with the nodes of its own cell and of the 8 cells around it.
+ */
+void TopologyBuilder::buildGeometric(double radius) {
+    if(radius <= 0)
+        throw cRuntimeError("geometricRadius must be positive");
+    int cells = std::max(1, std::min((int)(1 / radius), (int)ceil(sqrt((double)nodeCount))));
+    std::vector<double> x(nodeCount), y(nodeCount);
+    std::vector<int> cell(nodeCount), start(cells * cells + 1, 0), members(nodeCount);
+    for(int i = 0; i < nodeCount; i++) {
+        x[i] = uniform(0, 1);
+        y[i] = uniform(0, 1);
+        cell[i] = std::min((int)(x[i] * cells), cells - 1) * cells + std::min((int)(y[i] * cells), cells - 1);
+        start[cell[i] + 1]++;
+    }
+    for(int c = 0; c < cells * cells; c++)
+        start[c + 1] += start[c];
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for(int i = 0; i < nodeCount; i++)
+        members[fill[cell[i]]++] = i;
+
+    double r2 = radius * radius;
+    for(int i = 0; i < nodeCount; i++) {
+        int cx = cell[i] / cells, cy = cell[i] % cells;
+        for(int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, cells - 1); nx++)
+            for(int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, cells - 1); ny++)
+                for(int m = start[nx * cells + ny]; m < start[nx * cells + ny + 1]; m++) {
+                    int j = members[m];
+                    if(j > i && (x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]) < r2)
+                        connect(i, j);
+                }
+        if(getEnvir()->isGUI())
+            setPosition(i, x[i] * sqrt((double)nodeCount), y[i] * sqrt((double)nodeCount));
+    }
+}
+
+/*
+ * Places node[i] at (x, y), in units of the default node spacing.
+ */
+void TopologyBuilder::setPosition(int i, double x, double y) {
+    cDisplayString& ds = node(i)->getDisplayString();
+    ds.setTagArg("p", 0, (long)(x * 60));
+    ds.setTagArg("p", 1, (long)(y * 60));
+}
+
+/*
+ * Plain BFS over the port connections, run once per component.
+ */
+void TopologyBuilder::countComponents() {
+    std::vector<int> component(nodeCount, -1);
+    std::vector<int> queue;
+    queue.reserve(nodeCount);
+    components = largestComponent = 0;
+
+    for(int s = 0; s < nodeCount; s++) {
+        if(component[s] != -1)
+            continue;
+        queue.clear();
+        queue.push_back(s);
+        component[s] = components;
+        for(size_t head = 0; head < queue.size(); head++) {
+            cModule *n = node(queue[head]);
+            for(int i = 0; i < n->gateSize("port"); i++) {
+                cGate *g = n->gate("port$o", i);
+                if(!g->isConnected())
+                    continue;
+                int k = g->getPathEndGate()->getOwnerModule()->getIndex();
+                if(component[k] == -1) {
+                    component[k] = components;
+                    queue.push_back(k);
+                }
+            }
+        }
+        if(s == 0)
+            reachable = queue.size();
+        largestComponent = std::max(largestComponent, (int)queue.size());
+        components++;
+    }
+}
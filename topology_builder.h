@@ -0,0 +1,62 @@
+/*
+ * topology_builder.h
+ *
+ * Builds the connections of AsyncBFSNet for the topologies that can't be expressed
+ * in NED efficiently, and reports how much of the graph the root can reach.
+ */
+
+#ifndef TOPOLOGY_BUILDER_H_
+#define TOPOLOGY_BUILDER_H_
+
+#include <omnetpp.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+using namespace omnetpp;
+
+/*
+ * Runs in init stage 0, before the nodes look at their ports in stage 1.
+ *
+ * Topologies (network parameter `topology`), each built in O(N + M):
+ *  - "erdosRenyi":          G(n,p) with p = connectedness, built by the NED connections section
+ *  - "connectedErdosRenyi": random spanning tree plus G(n,p) extras, always connected
+ *  - "barabasiAlbert":      preferential attachment, every new node brings `baEdges` links
+ *  - "wattsStrogatz":       ring of `wsNeighbours` links on each side, each rewired with probability `wsRewire`
+ *  - "grid", "torus":       `gridDimensions`-dimensional (2 or 3) lattice, with wraparound links for the torus
+ *  - "geometric":           random geometric graph in the unit square, links shorter than `geometricRadius`
+ * `connectedness` only applies to the Erdos-Renyi topologies. Node positions of the grid and the
+ * geometric graph are copied to the display strings when running under a GUI.
+ *
+ * Whatever the topology, the connected components are counted once the connections exist,
+ * and the number of nodes reachable/unreachable from the root is recorded as scalars.
+ * If `skipDisconnected` is set, disconnected instances end the simulation before the root starts.
+ */
+class TopologyBuilder : public cSimpleModule {
+    int nodeCount = 0;
+    bool weightedLinks = false; // Connect through Link channels instead of plain connections
+    int reachable = 0;          // Nodes in the root's component, root included
+    int components = 0;         // Number of connected components
+    int largestComponent = 0;   // Size of the largest connected component
+    std::map<std::string, double> heaviest; // getHeaviestLink() by parameter, computed on first use
+
+    int numInitStages() const override { return 2; }
+    void initialize(int stage) override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+
+    cModule *node(int i);
+    void connect(int i, int j);
+    void buildConnectedErdosRenyi(double p);
+    void buildBarabasiAlbert(int m);
+    void buildWattsStrogatz(int k, double beta);
+    void buildGrid(int dimensions, bool torus);
+    void buildGeometric(double radius);
+    void setPosition(int i, double x, double y);
+    void countComponents();
+public:
+    double getHeaviestLink(const char *parName);    // Largest value of a channel parameter over all links, 1 for none
+};
+
+#endif /* TOPOLOGY_BUILDER_H_ */
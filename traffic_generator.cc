@@ -0,0 +1,107 @@
+/*
+ * traffic_generator.cc
+ *
+ * Sends data packets between random nodes over the next-hop tables built from the BFS tree,
+ * and measures the throughput, latency and path stretch of that routing.
+ */
+
+#include <algorithm>
+#include "traffic_generator.h"
+#include "async_bfs.h"
+#include "wire_size.h"
+
+Define_Module(TrafficGenerator);
+
+void TrafficGenerator::initialize() {
+    packetsLeft = par("packets").intValue();
+    if(par("startAt").doubleValue() < 0 || packetsLeft <= 0)
+        return;
+    timer = new cMessage("traffic");
+    scheduleAt(par("startAt"), timer);
+}
+
+/*
+ * Sends the next packet and schedules the one after it.
+ */
+void TrafficGenerator::handleMessage(cMessage *msg) {
+    int nodeCount = getParentModule()->par("nodeCount").intValue();
+    std::vector<int> labelled;
+    for(int i = 0; i < nodeCount; i++)
+        if(node(i)->getLabel() >= 0 && !node(i)->isCrashed())
+            labelled.push_back(i);
+
+    if(labelled.size() < 2) {
+        skipped++;
+    } else {
+        int from = labelled[intuniform(0, labelled.size() - 1)], to;
+        do
+            to = labelled[intuniform(0, labelled.size() - 1)];
+        while(to == from);
+        dataMessage *dMsg = new dataMessage("data", 15);
+        dMsg->setDestination(node(to)->getLabel());
+        dMsg->setHops(0);
+        dMsg->setShortestHops(shortestHops(from, to));
+        dMsg->setBitLength(KIND_BITS + varintBits(dMsg->getDestination()) + par("packetBits").intValue());
+        if(firstSent < SIMTIME_ZERO)
+            firstSent = simTime();
+        sent++;
+        node(from)->sendData(dMsg);
+    }
+    if(--packetsLeft > 0)
+        scheduleAt(simTime() + par("interarrival"), msg);
+}
+
+void TrafficGenerator::finish() {
+    recordScalar("packetsSent", sent);
+    recordScalar("packetsDelivered", delivered);
+    recordScalar("packetsSkipped", skipped);
+    if(delivered == 0)
+        return;
+    if(lastDelivered > firstSent)
+        recordScalar("throughput", bitsDelivered / (lastDelivered - firstSent).dbl());
+    recordScalar("meanLatency", latency / delivered);
+    recordScalar("meanHops", (double)hops / delivered);
+    recordScalar("meanStretch", stretch / delivered);
+    recordScalar("maxStretch", maxStretch);
+}
+
+void TrafficGenerator::packetDelivered(const dataMessage *msg) {
+    Enter_Method_Silent();
+    delivered++;
+    hops += msg->getHops();
+    double s = msg->getShortestHops() > 0 ? (double)msg->getHops() / msg->getShortestHops() : 1;
+    stretch += s;
+    maxStretch = std::max(maxStretch, s);
+    latency += simTime() - msg->getCreationTime();
+    lastDelivered = simTime();
+    bitsDelivered += msg->getBitLength();
+}
+
+TreeNode *TrafficGenerator::node(int i) {
+    return check_and_cast<TreeNode *>(getParentModule()->getSubmodule("node", i));
+}
+
+/*
+ * Fewest hops from node[from] to node[to] over the links and nodes that are up:
+ * BFS until `to` is reached, 0 if it can't be.
+ */
+int TrafficGenerator::shortestHops(int from, int to) {
+    int nodeCount = getParentModule()->par("nodeCount").intValue();
+    distance.assign(nodeCount, -1);
+    queue.clear();
+    queue.push_back(from);
+    distance[from] = 0;
+    for(size_t head = 0; head < queue.size(); head++) {
+        TreeNode *n = node(queue[head]);
+        for(int p = 0; p < n->gateSize("port"); p++) {
+            int k = n->getNeighbour(p);
+            if(!n->isPortUp(p) || distance[k] != -1 || node(k)->isCrashed())
+                continue;
+            distance[k] = distance[queue[head]] + 1;
+            if(k == to)
+                return distance[k];
+            queue.push_back(k);
+        }
+    }
+    return 0;
+}
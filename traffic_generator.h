@@ -0,0 +1,60 @@
+/*
+ * traffic_generator.h
+ *
+ * Sends data packets between random nodes over the next-hop tables built from the BFS tree,
+ * and measures the throughput, latency and path stretch of that routing.
+ */
+
+#ifndef TRAFFIC_GENERATOR_H_
+#define TRAFFIC_GENERATOR_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include "data_m.h"
+
+using namespace omnetpp;
+
+class TreeNode;
+
+/*
+ * From `startAt` on, every `interarrival` a packet of `packetBits` goes from a random labelled node to
+ * another one, until `packets` have been sent. The source only knows the destination's label, as it
+ * would get it from a name service; the nodes forward it hop by hop, see BFSNode::route().
+ * The labels come with the aggregation rounds of nodes with `routing` set, so `startAt` has to be after
+ * the first of them has ended; packets due before that are skipped.
+ *
+ * Scalars:
+ *  - `packetsSent`, `packetsDelivered`, `packetsSkipped` (no two labelled nodes yet)
+ *  - `throughput`:   delivered bits per second, from the first packet sent to the last one delivered
+ *  - `meanLatency`:  from sending to delivery
+ *  - `meanHops`, `meanStretch`, `maxStretch`: hops over the tree, and their ratio to the fewest hops
+ *    between the same nodes in the graph (computed centrally when the packet is sent)
+ */
+class TrafficGenerator : public cSimpleModule {
+    cMessage *timer = nullptr;
+    long packetsLeft = 0;
+    long sent = 0;
+    long skipped = 0;
+    long delivered = 0;
+    long hops = 0;
+    double stretch = 0;
+    double maxStretch = 0;
+    simtime_t latency;
+    simtime_t firstSent = -1;
+    simtime_t lastDelivered;
+    int64_t bitsDelivered = 0;
+    std::vector<int> distance;      // Scratch space of shortestHops()
+    std::vector<int> queue;
+
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+
+    TreeNode *node(int i);
+    int shortestHops(int from, int to);
+public:
+    virtual ~TrafficGenerator() { cancelAndDelete(timer); }
+    void packetDelivered(const dataMessage *msg);                   // Called by the destination node
+};
+
+#endif /* TRAFFIC_GENERATOR_H_ */
@@ -0,0 +1,165 @@
+/*
+ * tree_exporter.cc
+ *
+ * Writes the final BFS tree of the network to disk at the end of the run.
+ */
+
+#include <cmath>
+#include "tree_exporter.h"
+#include "async_bfs.h"
+
+Define_Module(TreeExporter);
+
+static const char TREE_MAGIC[4] = { 'B', 'F', 'S', 'T' };
+static const int32_t TREE_VERSION = 2;
+
+BufferedWriter::BufferedWriter(const char *fileName, size_t bufferSize) : fileName(fileName), buffer(bufferSize) {
+    f = fopen(fileName, "wb");
+    if(f)
+        setvbuf(f, nullptr, _IONBF, 0);                     // We do the buffering
+}
+
+BufferedWriter::~BufferedWriter() {
+    if(f)
+        fclose(f);
+}
+
+void BufferedWriter::flush() {
+    if(used > 0 && fwrite(buffer.data(), 1, used, f) != used)
+        throw cRuntimeError("Cannot write to `%s'", fileName.c_str());
+    used = 0;
+}
+
+void BufferedWriter::write(const void *data, size_t len) {
+    if(buffer.size() - used < len)
+        flush();
+    if(len > buffer.size()) {
+        if(fwrite(data, 1, len, f) != len)
+            throw cRuntimeError("Cannot write to `%s'", fileName.c_str());
+        return;
+    }
+    memcpy(buffer.data() + used, data, len);
+    used += len;
+}
+
+/*
+ * printf() straight into the buffer, flushing it first if the text doesn't fit in what is left.
+ */
+template<typename T>
+void BufferedWriter::format(const char *fmt, T v) {
+    int n = snprintf(buffer.data() + used, buffer.size() - used, fmt, v);
+    if(n >= 0 && (size_t)n >= buffer.size() - used) {
+        flush();
+        n = snprintf(buffer.data(), buffer.size(), fmt, v);
+    }
+    if(n < 0 || (size_t)n >= buffer.size() - used)
+        throw cRuntimeError("Cannot format `%s' for `%s'", fmt, fileName.c_str());
+    used += n;
+}
+
+void BufferedWriter::close() {
+    flush();
+    FILE *file = f;
+    f = nullptr;
+    bool failed = ferror(file) != 0;
+    if(fclose(file) != 0 || failed)
+        throw cRuntimeError("Cannot write to `%s'", fileName.c_str());
+}
+
+void TreeExporter::initialize() {
+}
+
+void TreeExporter::handleMessage(cMessage *msg) {
+    throw cRuntimeError("TreeExporter does not process messages");
+}
+
+/*
+ * Nodes keep their state until the network is deleted, so it doesn't matter
+ * whether our finish() is called before or after theirs.
+ */
+void TreeExporter::finish() {
+    cModule *network = getParentModule();
+    int nodeCount = network->par("nodeCount").intValue();
+
+    const char *binaryFile = par("binaryFile").stringValue();
+    const char *csvFile = par("csvFile").stringValue();
+    const char *graphmlFile = par("graphmlFile").stringValue();
+
+    if(*binaryFile)
+        writeBinary(binaryFile, network, nodeCount);
+    if(*csvFile)
+        writeCsv(csvFile, network, nodeCount);
+    if(*graphmlFile)
+        writeGraphml(graphmlFile, network, nodeCount);
+}
+
+void TreeExporter::writeBinary(const char *fileName, cModule *network, int nodeCount) {
+    BufferedWriter out(fileName);
+    if(!out.isOpen())
+        throw cRuntimeError("Cannot open `%s' for writing", fileName);
+
+    out.write(TREE_MAGIC, sizeof(TREE_MAGIC));
+    out.writeInt(TREE_VERSION);
+    out.writeInt(nodeCount);
+    for(int i = 0; i < nodeCount; i++) {
+        TreeNode *n = check_and_cast<TreeNode *>(network->getSubmodule("node", i));
+        const std::list<int>& children = n->getChildren();
+        out.writeInt(i);
+        out.writeInt(n->getParentNode());
+        out.writeDouble(n->getDistance());
+        out.writeInt((int32_t)children.size());
+        for(std::list<int>::const_iterator it = children.begin(); it != children.end(); it++)
+            out.writeInt(n->getNeighbour(*it));
+    }
+    out.close();
+}
+
+void TreeExporter::writeCsv(const char *fileName, cModule *network, int nodeCount) {
+    BufferedWriter out(fileName);
+    if(!out.isOpen())
+        throw cRuntimeError("Cannot open `%s' for writing", fileName);
+
+    out.writeString("node,parent,layer,children\n");
+    for(int i = 0; i < nodeCount; i++) {
+        TreeNode *n = check_and_cast<TreeNode *>(network->getSubmodule("node", i));
+        const std::list<int>& children = n->getChildren();
+        out.writeFormatted("%d,", i);
+        out.writeFormatted("%d,", n->getParentNode());
+        if(std::isinf(n->getDistance()))
+            out.writeString("INF,");
+        else
+            out.writeFormatted("%g,", n->getDistance());
+        for(std::list<int>::const_iterator it = children.begin(); it != children.end(); it++)
+            out.writeFormatted(it == children.begin() ? "%d" : ";%d", n->getNeighbour(*it));
+        out.writeString("\n");
+    }
+    out.close();
+}
+
+void TreeExporter::writeGraphml(const char *fileName, cModule *network, int nodeCount) {
+    BufferedWriter out(fileName);
+    if(!out.isOpen())
+        throw cRuntimeError("Cannot open `%s' for writing", fileName);
+
+    out.writeString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                    "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+                    "  <key id=\"layer\" for=\"node\" attr.name=\"layer\" attr.type=\"double\"/>\n"
+                    "  <graph id=\"bfs\" edgedefault=\"directed\">\n");
+    for(int i = 0; i < nodeCount; i++) {
+        TreeNode *n = check_and_cast<TreeNode *>(network->getSubmodule("node", i));
+        out.writeFormatted("    <node id=\"n%d\">", i);
+        if(std::isinf(n->getDistance()))
+            out.writeString("<data key=\"layer\">INF</data></node>\n");
+        else
+            out.writeFormatted("<data key=\"layer\">%g</data></node>\n", n->getDistance());
+    }
+    for(int i = 0; i < nodeCount; i++) {
+        TreeNode *n = check_and_cast<TreeNode *>(network->getSubmodule("node", i));
+        if(n->getParentNode() == -1)
+            continue;
+        out.writeFormatted("    <edge source=\"n%d\"", n->getParentNode());
+        out.writeFormatted(" target=\"n%d\"/>\n", i);
+    }
+    out.writeString("  </graph>\n</graphml>\n");
+    out.close();
+}
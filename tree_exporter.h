@@ -0,0 +1,76 @@
+/*
+ * tree_exporter.h
+ *
+ * Writes the final BFS tree of the network to disk at the end of the run.
+ */
+
+#ifndef TREE_EXPORTER_H_
+#define TREE_EXPORTER_H_
+
+#include <omnetpp.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace omnetpp;
+
+/*
+ * Minimal buffered writer on top of stdio. Records are encoded into one big buffer, which
+ * reaches the file with a single fwrite() whenever it is full. Numbers are written little-endian
+ * whatever the host. Failed writes, and a failed close(), end the run in a cRuntimeError.
+ */
+class BufferedWriter {
+    FILE *f = nullptr;
+    std::string fileName;
+    std::vector<char> buffer;
+    size_t used = 0;                    // Bytes of `buffer` not written out yet
+
+    void flush();
+    template<typename T> void format(const char *fmt, T v);
+public:
+    BufferedWriter(const char *fileName, size_t bufferSize = 1 << 20);
+    ~BufferedWriter();                  // Closes the file if close() wasn't reached, without checking
+    bool isOpen() const { return f != nullptr; }
+    void write(const void *data, size_t len);
+    void writeInt(int32_t v) { writeLittleEndian((uint32_t)v, sizeof(v)); }
+    void writeDouble(double v) {
+        uint64_t bits;
+        memcpy(&bits, &v, sizeof(v));
+        writeLittleEndian(bits, sizeof(v));
+    }
+    void writeLittleEndian(uint64_t v, size_t bytes) {
+        if(buffer.size() - used < bytes)
+            flush();
+        for(size_t i = 0; i < bytes; i++)
+            buffer[used++] = (char)(v >> (8 * i));
+    }
+    void writeString(const char *s) { write(s, strlen(s)); }
+    void writeFormatted(const char *fmt, int v) { format(fmt, v); }
+    void writeFormatted(const char *fmt, double v) { format(fmt, v); }
+    void close();                       // Writes out the rest of the buffer and closes the file
+};
+
+/*
+ * Collects (node, parent, layer, children) of every node in the parent network once the
+ * simulation is over and streams them to
+ *  - `binaryFile`:  "BFST" magic, int32 version (2), int32 node count, then per node
+ *                   int32 node, int32 parent node (-1 if none), float64 layer (the distance, inf if not reached),
+ *                   int32 child count, int32 children[]; all little-endian, the float64s in IEEE 754
+ *  - `csvFile`:     node,parent,layer,children (children separated by ';', layer INF if not reached)
+ *  - `graphmlFile`: tree edges as a GraphML document, layer as a node attribute (INF if not reached,
+ *                   as xs:double spells it)
+ * Empty file names disable the corresponding output.
+ */
+class TreeExporter : public cSimpleModule {
+    void initialize() override;
+    void handleMessage(cMessage *msg) override;
+    void finish() override;
+
+    void writeBinary(const char *fileName, cModule *network, int nodeCount);
+    void writeCsv(const char *fileName, cModule *network, int nodeCount);
+    void writeGraphml(const char *fileName, cModule *network, int nodeCount);
+};
+
+#endif /* TREE_EXPORTER_H_ */
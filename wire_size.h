@@ -0,0 +1,27 @@
+/*
+ * wire_size.h
+ *
+ * Encoded size of the protocol messages, used as their bit length so that
+ * datarate-limited links charge the right transmission time.
+ */
+
+#ifndef WIRE_SIZE_H_
+#define WIRE_SIZE_H_
+
+#include <stdint.h>
+
+const int KIND_BITS = 5;    // Message type tag: layer, ack, reject, bundle, reliable, link ack, the four repair messages, aggregation query, aggregate, label, data or sweep
+
+/*
+ * Size of v in LEB128 (7 payload bits per byte): small layers cost a byte, not a whole int.
+ */
+inline int varintBits(uint64_t v) {
+    int bytes = 1;
+    while(v >= 0x80) {
+        v >>= 7;
+        bytes++;
+    }
+    return 8 * bytes;
+}
+
+#endif /* WIRE_SIZE_H_ */